@@ -23,6 +23,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <libgame.hpp>
 #include <libview/view.hpp>
 #include <libutil/log.hpp>
+#include <libutil/overload.hpp>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Renderer.h>
@@ -30,6 +31,11 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <Magnum/Math/Color.h>
 #include <Magnum/Platform/Sdl2Application.h>
 #include <Corrade/Utility/Arguments.h>
+#include <iostream>
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#include <emscripten/html5.h>
+#endif
 
 namespace
 {
@@ -39,6 +45,7 @@ namespace
         bool enable_log = false;
         bool show_fps_counter = false;
         bool fail_on_db_error = false;
+        bool show_db_metrics = false;
     };
 
     configuration parse_command_line(const int argc, char** const argv)
@@ -48,6 +55,7 @@ namespace
         args.addBooleanOption("log").setHelp("log", "enable log");
         args.addBooleanOption("fps").setHelp("fps", "show FPS counter");
         args.addBooleanOption("fail-on-db-error").setHelp("fail-on-db-error", "fail on database access error");
+        args.addBooleanOption("db-metrics").setHelp("db-metrics", "print database read and write metrics");
 
         if(args.tryParse(argc, argv))
         {
@@ -56,7 +64,8 @@ namespace
                 .show_debug_grid = args.isSet("debug-grid"),
                 .enable_log = args.isSet("log"),
                 .show_fps_counter = args.isSet("fps"),
-                .fail_on_db_error = args.isSet("fail-on-db-error")
+                .fail_on_db_error = args.isSet("fail-on-db-error"),
+                .show_db_metrics = args.isSet("db-metrics")
             };
         }
         else
@@ -106,26 +115,75 @@ class app: public Magnum::Platform::Sdl2Application
             ),
             fsm_(ctx_)
         {
+#ifndef __EMSCRIPTEN__
+            //Since we override tickEvent(), the main loop doesn't wait for
+            //input events anymore. Don't let it spin when nothing is drawn.
+            setMinimalLoopPeriod(16);
+#endif
+
+#ifdef __EMSCRIPTEN__
+            //Save the pending changes before the page gets hidden or closed,
+            //as the browser may kill the page without further notice
+            emscripten_set_visibilitychange_callback
+            (
+                this,
+                false,
+                [](int, const EmscriptenVisibilityChangeEvent* event, void* user_data) -> EM_BOOL
+                {
+                    if(event->hidden)
+                    {
+                        static_cast<app*>(user_data)->database_.flush();
+                    }
+                    return EM_FALSE;
+                }
+            );
+            emscripten_set_beforeunload_callback
+            (
+                this,
+                [](int, const void*, void* user_data) -> const char*
+                {
+                    static_cast<app*>(user_data)->database_.flush();
+                    return nullptr;
+                }
+            );
+#endif
+
             fsm_.process_event(events::start{});
         }
 
     //Sdl2Application virtual functions
     private:
-        void drawEvent() override
+        void tickEvent() override
         {
             const auto now = std::chrono::steady_clock::now();
             const auto elapsed_s = std::chrono::duration<double>{now - previous_frame_time_}.count();
             previous_frame_time_ = now;
 
             //Advance
+            database_.advance();
             fsm_.process_event(events::iteration{now, elapsed_s});
             view_.advance(now, elapsed_s);
 
-            //Draw
+            //Only draw a new frame if it differs from the previous one
+            if(view_.needs_redraw())
+            {
+                redraw();
+            }
+
+#ifdef __EMSCRIPTEN__
+            //The browser runs the main loop at display rate. When there's
+            //nothing to draw, tick from a slower timer instead.
+            set_idle(!view_.needs_redraw());
+#endif
+
+            libutil::log::advance();
+        }
+
+        void drawEvent() override
+        {
             Magnum::GL::defaultFramebuffer.clear(Magnum::GL::FramebufferClear::Color);
             view_.draw();
             swapBuffers();
-            redraw();
         }
 
         void viewportEvent(ViewportEvent& event) override
@@ -160,13 +218,46 @@ class app: public Magnum::Platform::Sdl2Application
         }
 
     private:
+#ifdef __EMSCRIPTEN__
+        void set_idle(const bool idle)
+        {
+            if(idle == idle_)
+            {
+                return;
+            }
+
+            idle_ = idle;
+
+            if(idle)
+            {
+                emscripten_set_main_loop_timing(EM_TIMING_SETTIMEOUT, idle_tick_period_ms);
+            }
+            else
+            {
+                emscripten_set_main_loop_timing(EM_TIMING_RAF, 1);
+            }
+        }
+#endif
+
         void handle_database_event(const libdb::event& event)
         {
             std::visit
             (
-                [this](const auto& event)
+                libutil::overload
                 {
-                    fsm_.process_event(event);
+                    [this](const libdb::events::end_of_loading& event)
+                    {
+                        fsm_.process_event(event);
+                    },
+                    [this](const auto& metrics)
+                    {
+                        //Printed directly, so that they don't depend on (and
+                        //don't enable) the log
+                        if(conf_.show_db_metrics)
+                        {
+                            std::cout << "[app <- db] " << metrics << '\n';
+                        }
+                    }
                 },
                 event
             );
@@ -181,6 +272,12 @@ class app: public Magnum::Platform::Sdl2Application
         fsm fsm_;
 
         std::chrono::steady_clock::time_point previous_frame_time_ = std::chrono::steady_clock::now();
+
+#ifdef __EMSCRIPTEN__
+        //Also bounds the latency of the first input event after an idle period
+        static constexpr int idle_tick_period_ms = 50;
+        bool idle_ = false;
+#endif
 };
 
 MAGNUM_APPLICATION_MAIN(app)
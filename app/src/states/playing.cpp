@@ -23,31 +23,6 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 namespace states
 {
 
-namespace
-{
-    std::optional<libgame::data_types::stage_state> find_stage_state
-    (
-        const std::optional<libdb::data_types::game_state>& opt_game_state,
-        const libgame::data_types::stage stage
-    )
-    {
-        if(!opt_game_state)
-        {
-            return std::nullopt;
-        }
-
-        const auto& game_state = *opt_game_state;
-
-        const auto stage_state_it = game_state.stage_states.find(stage);
-        if(stage_state_it == game_state.stage_states.end())
-        {
-            return std::nullopt;
-        }
-
-        return stage_state_it->second;
-    }
-}
-
 playing_impl::playing_impl
 (
     context& ctx,
@@ -67,11 +42,17 @@ playing_impl::playing_impl
                 {
                     libutil::log::info("[fsm <- screen] Clear request");
                     modify_game(&libgame::game::start);
+                    save_game();
                 },
                 .handle_drop_request = [this](const libview::data_types::input_layout input_layout)
                 {
                     libutil::log::info("[fsm <- screen] Drop request with layout: ", input_layout);
+                    const auto move_count = pgame_->get_state().move_count;
                     modify_game(&libgame::game::drop_input_tiles, input_layout);
+                    if(pgame_->get_state().move_count != move_count)
+                    {
+                        ctx_.database.add_move(stage_, input_layout, pgame_->get_state());
+                    }
                 },
                 .handle_exit_request = [this, trans]
                 {
@@ -102,16 +83,13 @@ playing_impl::playing_impl
         )
     )
 {
-    //Load game state from database
-    const auto& opt_game_state = ctx_.database.get_game_state();
-
-    //Find stage state
-    const auto opt_stage_state = find_stage_state(opt_game_state, stage);
+    //Get stage state from database (loaded by the stage selection state)
+    const auto pstage_state = ctx_.database.find_stage_state(stage);
 
     //Create game
-    if(opt_stage_state)
+    if(pstage_state)
     {
-        const auto& stage_state = *opt_stage_state;
+        const auto& stage_state = *pstage_state;
         const auto& board = stage_state.brd;
 
         pgame_ = std::make_unique<libgame::game>(stage, stage_state);
@@ -132,6 +110,7 @@ playing_impl::playing_impl
     {
         pgame_ = std::make_unique<libgame::game>(stage);
         modify_game(&libgame::game::start);
+        save_game();
     }
 
     ctx_.view.show_screen(pscreen_, trans);
@@ -94,7 +94,6 @@ class playing_impl
         {
             pscreen_->insert_next_input();
             show_preview();
-            save_game();
         }
 
         void handle_game_event(const libgame::events::input_tile_drop& event)
@@ -134,7 +133,19 @@ class playing_impl
         void handle_game_event(const libgame::events::end_of_game&)
         {
             pscreen_->set_game_over_overlay_visible(true);
-            save_game();
+
+            const auto& state = pgame_->get_state();
+            ctx_.database.add_finished_game
+            (
+                stage_,
+                libdb::data_types::game_record
+                {
+                    .score = get_score(state.brd),
+                    .move_count = state.move_count,
+                    .time_s = state.time_s,
+                    .max_tile_value = get_highest_tile_value(state.brd)
+                }
+            );
         }
 
         void handle_game_events(const libgame::event_list& events)
@@ -41,14 +41,9 @@ struct showing_hi_score_screen
 
                 //get hi-scores
                 auto scores = screen::score_map{};
-                if(const auto& opt_game_state = ctx.database.get_game_state())
+                for(const auto& [stage, summary]: ctx.database.get_stage_summaries())
                 {
-                    const auto& game_state = opt_game_state.value();
-                    const auto& stage_states = game_state.stage_states;
-                    for(const auto& [stage, stage_state]: stage_states)
-                    {
-                        scores.insert({stage, stage_state.hi_score});
-                    }
+                    scores.insert({stage, summary.hi_score});
                 }
 
                 auto pscreen = ctx.view.make_screen<screen>
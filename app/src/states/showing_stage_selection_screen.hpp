@@ -36,6 +36,15 @@ struct showing_stage_selection_screen
 
             [this](const events::stage_selection_screen_show_request& event)
             {
+                //Load the stage the player is likely to choose while they're
+                //choosing
+                if(const auto opt_stage = ctx.database.get_last_played_stage())
+                {
+                    ctx.database.prefetch_stage_state(*opt_stage);
+                }
+
+                stage_load_pending = false;
+
                 using screen = libview::screens::stage_selection;
                 auto pscreen = ctx.view.make_screen<screen>
                 (
@@ -47,21 +56,39 @@ struct showing_stage_selection_screen
                             const Magnum::Vector2& stage_symbol_position
                         )
                         {
-                            ctx.process_event
+                            //Ignore the selections made while a stage is
+                            //being loaded
+                            if(stage_load_pending)
+                            {
+                                return;
+                            }
+                            stage_load_pending = true;
+
+                            //Wait for the stage state to be loaded (the
+                            //callback is called right away if it's already
+                            //the case)
+                            ctx.database.async_get_stage_state
                             (
-                                events::play_screen_show_request
+                                stage,
+                                [this, stage, stage_symbol_position](const libdb::data_types::stage_state*)
                                 {
-                                    data_types::screen_transitions::zoom_in
-                                    {
-                                        .duration_s = 1.0f,
-                                        .new_screen_start_position = Magnum::Vector2
+                                    ctx.process_event
+                                    (
+                                        events::play_screen_show_request
                                         {
-                                            stage_symbol_position.x(),
-                                            stage_symbol_position.y() + 0.25f
-                                        },
-                                        .new_screen_start_scaling = 0.25f
-                                    },
-                                    stage
+                                            data_types::screen_transitions::zoom_in
+                                            {
+                                                .duration_s = 1.0f,
+                                                .new_screen_start_position = Magnum::Vector2
+                                                {
+                                                    stage_symbol_position.x(),
+                                                    stage_symbol_position.y() + 0.25f
+                                                },
+                                                .new_screen_start_scaling = 0.25f
+                                            },
+                                            stage
+                                        }
+                                    );
                                 }
                             );
                         },
@@ -83,6 +110,7 @@ struct showing_stage_selection_screen
     }
 
     context& ctx;
+    bool stage_load_pending = false;
 };
 
 } //namespace
@@ -0,0 +1,359 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Benchmark and regression test of the persistence layer.
+
+Drives libdb::database on top of the fake IndexedDB (with simulated latency
+and failures), checks the number of writes and that saved states load back
+identically, and prints the measured durations.
+Returns a non-zero exit code if a check fails.
+*/
+
+#include <libdb/database.hpp>
+#include <libdb/fake_indexed_db.hpp>
+#include <libgame.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <variant>
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    constexpr auto stage = libdb::data_types::stage::purity_chapel;
+
+    int failed_check_count = 0;
+
+    void check(const bool condition, const char* description)
+    {
+        std::cout << (condition ? "[ OK ] " : "[FAIL] ") << description << '\n';
+        if(!condition)
+        {
+            ++failed_check_count;
+        }
+    }
+
+    std::string to_string(const libdb::data_types::stage_state& state)
+    {
+        auto out = std::ostringstream{};
+
+        const auto print_tiles = [&](const auto& tiles)
+        {
+            for(const auto& opt_tile: tiles.data)
+            {
+                if(opt_tile)
+                {
+                    std::visit([&](const auto& tile){out << tile;}, *opt_tile);
+                }
+                out << ';';
+            }
+            out << '\n';
+        };
+
+        out << state.hi_score << ' ' << state.move_count << ' ' << state.time_s << '\n';
+        print_tiles(state.next_input_tiles);
+        print_tiles(state.input_tiles);
+        print_tiles(state.brd.tiles);
+
+        return out.str();
+    }
+
+    double get_elapsed_ms(const clock::time_point start_time)
+    {
+        return std::chrono::duration<double, std::milli>{clock::now() - start_time}.count();
+    }
+
+    //Open a database and wait for the end of loading
+    std::unique_ptr<libdb::database> open_database(std::unique_ptr<libdb::storage_backend>&& pbackend)
+    {
+        auto loaded = false;
+        auto pdb = std::make_unique<libdb::database>
+        (
+            false,
+            [&loaded](const libdb::event& event)
+            {
+                if(std::holds_alternative<libdb::events::end_of_loading>(event))
+                {
+                    loaded = true;
+                }
+            },
+            std::move(pbackend)
+        );
+
+        const auto start_time = clock::now();
+        while(!loaded && get_elapsed_ms(start_time) < 5000)
+        {
+            pdb->advance();
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        check(loaded, "database loads");
+        std::cout << "       loading took " << get_elapsed_ms(start_time) << " ms\n";
+
+        return pdb;
+    }
+
+    //Return nullptr if the state doesn't load in time
+    const libdb::data_types::stage_state* load_stage_state(libdb::database& db)
+    {
+        auto done = false;
+        const libdb::data_types::stage_state* pstate = nullptr;
+        db.async_get_stage_state
+        (
+            stage,
+            [&](const libdb::data_types::stage_state* p)
+            {
+                done = true;
+                pstate = p;
+            }
+        );
+
+        const auto start_time = clock::now();
+        while(!done && get_elapsed_ms(start_time) < 5000)
+        {
+            db.advance();
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        return pstate;
+    }
+
+    //Choose the move that leaves the fewest tiles, so that the game lasts
+    libgame::data_types::input_layout choose_layout(const libgame::data_types::stage_state& state)
+    {
+        auto best_layout = libgame::data_types::input_layout{};
+        auto best_tile_count = std::numeric_limits<int>::max();
+
+        for(auto rotation = 0; rotation < 4; ++rotation)
+        {
+            for(auto col_offset = 0; col_offset < 5; ++col_offset)
+            {
+                const auto layout = libgame::data_types::input_layout{col_offset, rotation};
+
+                auto game = libgame::game{stage, state};
+                auto events = libgame::event_list{};
+                game.drop_input_tiles(layout, events);
+
+                const auto& brd = game.get_state().brd;
+                const auto tile_count = libgame::data_types::is_overflowed(brd) ?
+                    std::numeric_limits<int>::max() - 1 :
+                    libgame::data_types::get_tile_count(brd)
+                ;
+
+                if(tile_count < best_tile_count)
+                {
+                    best_layout = layout;
+                    best_tile_count = tile_count;
+                }
+            }
+        }
+
+        return best_layout;
+    }
+
+    //Play the given number of moves from the given state, saving each of them
+    libdb::data_types::stage_state play
+    (
+        libdb::database& db,
+        const libdb::data_types::stage_state& state,
+        const int move_count
+    )
+    {
+        auto events = libgame::event_list{};
+        auto game = libgame::game{stage, state};
+
+        for(auto i = 0; i < move_count && !game.is_over(); ++i)
+        {
+            const auto layout = choose_layout(game.get_state());
+
+            events.clear();
+            game.drop_input_tiles(layout, events);
+            db.add_move(stage, layout, game.get_state());
+        }
+
+        return game.get_state();
+    }
+
+    //Start a new game and play the given number of moves
+    libdb::data_types::stage_state play(libdb::database& db, const int move_count)
+    {
+        auto events = libgame::event_list{};
+        auto game = libgame::game{stage};
+        game.start(events);
+        db.set_stage_state(stage, game.get_state());
+
+        return play(db, game.get_state(), move_count);
+    }
+
+    //A burst of moves must be coalesced into a single write
+    void test_write_coalescing()
+    {
+        std::cout << "Write coalescing\n";
+
+        libdb::fake_indexed_db::reset();
+        libdb::fake_indexed_db::configure({.latency = std::chrono::milliseconds{5}});
+
+        auto pdb = open_database(libdb::make_indexed_db_storage_backend());
+
+        auto events = libgame::event_list{};
+        auto game = libgame::game{stage};
+        game.start(events);
+        pdb->set_stage_state(stage, game.get_state());
+        pdb->flush();
+
+        libdb::fake_indexed_db::reset_statistics();
+
+        auto state = game.get_state();
+        for(auto i = 0; i < 20; ++i)
+        {
+            ++state.move_count;
+            pdb->add_move(stage, libgame::data_types::input_layout{}, state);
+        }
+
+        pdb->advance();
+        check(libdb::fake_indexed_db::get_statistics().write_count == 0, "writes are debounced");
+
+        const auto start_time = clock::now();
+        pdb->flush();
+        std::cout << "       flush took " << get_elapsed_ms(start_time) << " ms\n";
+
+        const auto& stats = libdb::fake_indexed_db::get_statistics();
+        check(stats.write_count == 1, "20 moves give one write");
+        std::cout << "       " << stats.written_byte_count << " bytes written\n";
+    }
+
+    //Snapshots saved on the fake IndexedDB must load back identically
+    void test_snapshot_round_trip()
+    {
+        std::cout << "Snapshot round trip\n";
+
+        libdb::fake_indexed_db::reset();
+        libdb::fake_indexed_db::configure({.latency = std::chrono::milliseconds{1}});
+
+        auto expected_state = libdb::data_types::stage_state{};
+        {
+            auto pdb = open_database(libdb::make_indexed_db_storage_backend());
+            expected_state = play(*pdb, 40);
+        }
+
+        auto pdb = open_database(libdb::make_indexed_db_storage_backend());
+        const auto pstate = load_stage_state(*pdb);
+        check(pstate && to_string(*pstate) == to_string(expected_state), "stage state loads back");
+        check(pdb->get_last_played_stage() == stage, "last played stage loads back");
+    }
+
+    //Snapshots and move journals saved on files must load back identically
+    void test_journal_round_trip()
+    {
+        std::cout << "Journal round trip\n";
+
+        const auto root_dir = std::filesystem::temp_directory_path() / "libdb-bench";
+        const auto journal_path = root_dir / "ternarii" / "stage_journal_0";
+        std::filesystem::remove_all(root_dir);
+
+        auto expected_state = libdb::data_types::stage_state{};
+        {
+            auto pdb = open_database(libdb::make_file_storage_backend(root_dir));
+
+            //More moves than the journal holds, to go through a compaction
+            expected_state = play(*pdb, 45);
+        }
+
+        check(expected_state.move_count == 45, "the game goes through a journal compaction");
+        check(std::filesystem::file_size(journal_path) > 16, "moves are journaled");
+
+        {
+            auto pdb = open_database(libdb::make_file_storage_backend(root_dir));
+            const auto pstate = load_stage_state(*pdb);
+            check(pstate && to_string(*pstate) == to_string(expected_state), "stage state loads back");
+        }
+
+        //Simulate an append interrupted in the middle of a record
+        {
+            auto file = std::ofstream{journal_path, std::ios::binary | std::ios::app};
+            file << "torn";
+        }
+
+        {
+            auto pdb = open_database(libdb::make_file_storage_backend(root_dir));
+            const auto pstate = load_stage_state(*pdb);
+            check(pstate && to_string(*pstate) == to_string(expected_state), "stage state loads back despite a torn record");
+            if(pstate)
+            {
+                expected_state = play(*pdb, *pstate, 3);
+            }
+        }
+
+        auto pdb = open_database(libdb::make_file_storage_backend(root_dir));
+        const auto pstate = load_stage_state(*pdb);
+        check(pstate && to_string(*pstate) == to_string(expected_state), "moves played after a torn record load back");
+
+        pdb.reset();
+        std::filesystem::remove_all(root_dir);
+    }
+
+    //Failed writes must neither crash nor prevent the next ones
+    void test_write_failures()
+    {
+        std::cout << "Write failures\n";
+
+        libdb::fake_indexed_db::reset();
+        libdb::fake_indexed_db::configure({.failure_probability = 1});
+
+        auto expected_state = libdb::data_types::stage_state{};
+        {
+            auto pdb = std::make_unique<libdb::database>
+            (
+                false,
+                [](const libdb::event&){},
+                libdb::make_indexed_db_storage_backend()
+            );
+            play(*pdb, 5);
+            pdb->flush();
+
+            check(libdb::fake_indexed_db::get_statistics().failure_count > 0, "failures are injected");
+
+            libdb::fake_indexed_db::configure({});
+            expected_state = play(*pdb, 5);
+        }
+
+        auto pdb = open_database(libdb::make_indexed_db_storage_backend());
+        const auto pstate = load_stage_state(*pdb);
+        check(pstate && to_string(*pstate) == to_string(expected_state), "stage state saved after failures loads back");
+    }
+}
+
+int main()
+{
+    test_write_coalescing();
+    test_snapshot_round_trip();
+    test_journal_round_trip();
+    test_write_failures();
+
+    return failed_check_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -21,7 +21,9 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDB_DATA_TYPES_HPP
 
 #include <libgame.hpp>
+#include <cstdint>
 #include <map>
+#include <vector>
 
 namespace libdb::data_types
 {
@@ -32,12 +34,58 @@ using tile        = libgame::data_types::tile;
 
 using stage_state_map = std::map<stage, stage_state>;
 
+//Keep in sync with the last enumerator of stage
+constexpr auto stage_count = static_cast<int>(stage::waterfalls) + 1;
+
 //State of the whole game
 struct game_state
 {
     stage_state_map stage_states;
 };
 
+//What's known about a stage without loading its state
+struct stage_summary
+{
+    int hi_score = 0;
+};
+
+using stage_summary_map = std::map<stage, stage_summary>;
+
+//Finished game, as recorded in the game history of a stage
+struct game_record
+{
+    //Position in the game history of the stage (set by the database)
+    int index = 0;
+
+    int score = 0;
+    int move_count = 0;
+    double time_s = 0;
+    int max_tile_value = 0;
+
+    //Seed of the input generator, if the caller knows it (0 otherwise)
+    std::uint32_t seed = 0;
+};
+
+//Aggregates over all the finished games of a stage
+struct game_history_stats
+{
+    int game_count = 0;
+    int best_score = 0;
+    int best_tile_value = 0;
+    std::int64_t total_score = 0;
+    std::int64_t total_move_count = 0;
+    double total_time_s = 0;
+};
+
+//What's known about the game history of a stage without loading it
+struct game_ranking
+{
+    game_history_stats stats;
+
+    //Best games, by decreasing score (earliest first on ties)
+    std::vector<game_record> best_games;
+};
+
 } //namespace
 
 #endif
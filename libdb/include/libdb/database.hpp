@@ -22,7 +22,10 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "events.hpp"
 #include "data_types.hpp"
+#include "storage_backend.hpp"
+#include <functional>
 #include <memory>
+#include <optional>
 
 namespace libdb
 {
@@ -30,14 +33,82 @@ namespace libdb
 class database
 {
     public:
+        //Use make_default_storage_backend()
         database(bool fail_on_access_error, const event_handler& evt_handler);
 
+        database
+        (
+            bool fail_on_access_error,
+            const event_handler& evt_handler,
+            std::unique_ptr<storage_backend>&& pbackend
+        );
+
         ~database();
 
-        const std::optional<data_types::game_state>& get_game_state() const;
+        //Complete the pending storage operations. Call once per frame.
+        void advance();
+
+        /*
+        Start writing the pending changes right away.
+        Call when the application is about to be hidden or closed.
+        Note: Also called by the destructor.
+        */
+        void flush();
+
+        using stage_state_callback = std::function<void(const data_types::stage_state*)>;
+
+        //Available as soon as loading ends
+        const data_types::stage_summary_map& get_stage_summaries() const;
+
+        //Stage of the last saved state, if any (available as soon as loading
+        //ends)
+        std::optional<data_types::stage> get_last_played_stage() const;
+
+        //Start loading the state of the given stage in the background
+        void prefetch_stage_state(data_types::stage stage);
 
+        /*
+        Load the state of the given stage, if needed, and give it to the
+        callback (nullptr if the stage has never been played).
+        Note: If the state is already loaded, the callback is called right
+        away.
+        */
+        void async_get_stage_state(data_types::stage stage, const stage_state_callback& callback);
+
+        //Return nullptr if the state isn't loaded or doesn't exist
+        const data_types::stage_state* find_stage_state(data_types::stage stage) const;
+
+        //Save a snapshot of the state of the given stage
         void set_stage_state(data_types::stage stage, const data_types::stage_state& state);
 
+        /*
+        Save the given move (see libgame::game::drop_input_tiles()) and the
+        resulting state.
+        On backends that can append natively, the move is appended to the
+        journal of the stage, which is compacted into a new snapshot every few
+        moves. Otherwise, a new snapshot is saved (which is smaller than a
+        journal to rewrite).
+        */
+        void add_move
+        (
+            data_types::stage stage,
+            const libgame::data_types::input_layout& layout,
+            const data_types::stage_state& state
+        );
+
+        using game_ranking_callback = std::function<void(const data_types::game_ranking&)>;
+
+        //Record a finished game in the game history of the given stage
+        void add_finished_game(data_types::stage stage, const data_types::game_record& record);
+
+        /*
+        Load the aggregates and the best games of the given stage, if needed,
+        and give them to the callback. Only the last segment of the game
+        history is loaded.
+        Note: If they're already loaded, the callback is called right away.
+        */
+        void async_get_game_ranking(data_types::stage stage, const game_ranking_callback& callback);
+
     private:
         struct impl;
         std::unique_ptr<impl> pimpl_;
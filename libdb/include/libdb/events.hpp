@@ -23,6 +23,10 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <variant>
 #include <functional>
 #include <libutil/void_function.hpp>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
 
 namespace libdb
 {
@@ -30,11 +34,59 @@ namespace libdb
 namespace events
 {
     struct end_of_loading{};
+
+    //Sent after each read of a database entry
+    struct read_metrics
+    {
+        std::string key;
+        std::size_t byte_count = 0;
+
+        //From the request to the callback of the storage backend
+        std::chrono::microseconds read_duration{0};
+
+        //Spent in the callback, decoding the data
+        std::chrono::microseconds parse_duration{0};
+
+        //Storage transactions in flight when the read started, the read
+        //included
+        int overlapping_transaction_count = 0;
+
+        bool success = true;
+    };
+
+    std::ostream& operator<<(std::ostream& l, const read_metrics& r);
+
+    //Sent after each write (or append) of a database entry
+    struct write_metrics
+    {
+        std::string key;
+        std::size_t byte_count = 0;
+        bool append = false;
+
+        std::chrono::microseconds encode_duration{0};
+
+        //From the first request of the write (coalesced writes and debounce
+        //delay included) to its completion
+        std::chrono::microseconds request_to_completion_duration{0};
+
+        //From the start of the write to its completion
+        std::chrono::microseconds write_duration{0};
+
+        //Storage transactions in flight when the write started, the write
+        //included
+        int overlapping_transaction_count = 0;
+
+        bool success = true;
+    };
+
+    std::ostream& operator<<(std::ostream& l, const write_metrics& r);
 }
 
 using event = std::variant
 <
-    events::end_of_loading
+    events::end_of_loading,
+    events::read_metrics,
+    events::write_metrics
 >;
 
 using event_handler = libutil::void_function<const event&>;
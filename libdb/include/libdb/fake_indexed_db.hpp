@@ -0,0 +1,92 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDB_FAKE_INDEXED_DB_HPP
+#define LIBDB_FAKE_INDEXED_DB_HPP
+
+#include <chrono>
+#include <cstddef>
+
+/*
+In-process stand-in for IndexedDB, for native builds.
+
+It implements the API of indexed_db.hpp (and therefore backs
+make_indexed_db_storage_backend()), so that the persistence layer can be
+exercised and measured without a browser.
+
+Transactions are executed one at a time, in the order they're issued, like
+on a single IndexedDB connection. A transaction completes (and its callback
+is called) from poll() or wait(), once its simulated duration has elapsed:
+    latency + size / throughput
+
+Data is kept in memory and lost when the process exits.
+Not thread-safe.
+*/
+
+namespace libdb::fake_indexed_db
+{
+
+struct configuration
+{
+    //Duration of every transaction
+    std::chrono::microseconds latency{0};
+
+    //In bytes per second, for both reads and writes (0 = unlimited)
+    double throughput = 0;
+
+    //Probability for each transaction to fail
+    double failure_probability = 0;
+
+    //Seed of the failure injection
+    unsigned int seed = 0;
+};
+
+struct statistics
+{
+    int read_count = 0;
+    int write_count = 0;
+    int failure_count = 0;
+    std::size_t read_byte_count = 0;
+    std::size_t written_byte_count = 0;
+};
+
+void configure(const configuration& conf);
+
+const statistics& get_statistics();
+
+void reset_statistics();
+
+//Remove all the data, pending transactions and statistics
+void reset();
+
+//Number of transactions that haven't completed yet
+int get_pending_transaction_count();
+
+//Complete the transactions whose time has come
+void poll();
+
+/*
+Sleep until the next pending transaction completes, then complete it.
+Return false if there's no pending transaction.
+*/
+bool wait();
+
+} //namespace
+
+#endif
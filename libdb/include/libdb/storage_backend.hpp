@@ -0,0 +1,137 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDB_STORAGE_BACKEND_HPP
+#define LIBDB_STORAGE_BACKEND_HPP
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+namespace libdb
+{
+
+/*
+Interface of the key-value storages the database is persisted into.
+
+Entries are identified by a database name and a store name (which only need
+to be valid during the call).
+Operations complete asynchronously: callbacks are never called from within
+async_read() or async_write().
+*/
+class storage_backend
+{
+    public:
+        using read_success_callback_t  = std::function<void(const void* data, int size)>;
+        using write_success_callback_t = std::function<void()>;
+        using failure_callback_t       = std::function<void(const char* error)>;
+
+        virtual ~storage_backend() = default;
+
+        /*
+        Reads given entry.
+        The data given to success_callback is only valid during the call.
+        Note: If given entry doesn't exist, calls success_callback(nullptr, 0).
+        */
+        virtual void async_read
+        (
+            const char* database_name,
+            const char* store_name,
+            const read_success_callback_t& success_callback,
+            const failure_callback_t& failure_callback
+        ) = 0;
+
+        /*
+        Writes given entry.
+        The data must stay valid until one of the callbacks is called.
+        */
+        virtual void async_write
+        (
+            const char* database_name,
+            const char* store_name,
+            const void* data,
+            int size,
+            const write_success_callback_t& success_callback,
+            const failure_callback_t& failure_callback
+        ) = 0;
+
+        /*
+        Appends to given entry, creating it if needed.
+        The data must stay valid until one of the callbacks is called.
+        Note: The default implementation reads the entry and writes it back
+        with the data appended (see has_native_append()).
+        */
+        virtual void async_append
+        (
+            const char* database_name,
+            const char* store_name,
+            const void* data,
+            int size,
+            const write_success_callback_t& success_callback,
+            const failure_callback_t& failure_callback
+        );
+
+        /*
+        Whether async_append() is implemented by the backend itself, and is
+        therefore cheaper than rewriting the entry.
+        */
+        virtual bool has_native_append() const
+        {
+            return false;
+        }
+
+        /*
+        Completes the pending operations that are ready.
+        Must be called regularly (e.g. once per frame) by backends that don't
+        have their own event loop.
+        */
+        virtual void poll()
+        {
+        }
+
+        /*
+        Blocks until some pending operations complete, if the backend can.
+        Returns false if there's nothing to wait for or if the backend can't
+        block (e.g. because operations complete in the browser event loop).
+        */
+        virtual bool wait()
+        {
+            return false;
+        }
+};
+
+/*
+IndexedDB backend.
+On native builds, runs on top of an in-process fake (see
+fake_indexed_db.hpp).
+*/
+std::unique_ptr<storage_backend> make_indexed_db_storage_backend();
+
+/*
+File backend (native builds only).
+Each entry is stored in <root_dir>/<database_name>/<store_name>.
+*/
+std::unique_ptr<storage_backend> make_file_storage_backend(const std::filesystem::path& root_dir);
+
+//IndexedDB backend on Emscripten builds, file backend on native builds
+std::unique_ptr<storage_backend> make_default_storage_backend();
+
+} //namespace
+
+#endif
@@ -0,0 +1,775 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "binary_conversion.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace libdb
+{
+
+namespace
+{
+    constexpr auto magic = std::array<char, 4>{'T', 'R', 'N', 'R'};
+    constexpr auto journal_magic = std::array<char, 4>{'T', 'R', 'N', 'J'};
+    constexpr auto index_magic = std::array<char, 4>{'T', 'R', 'N', 'I'};
+    constexpr auto game_history_magic = std::array<char, 4>{'T', 'R', 'N', 'H'};
+    constexpr auto game_ranking_magic = std::array<char, 4>{'T', 'R', 'N', 'K'};
+
+    constexpr auto header_size = std::size_t{16};
+    constexpr auto record_size = std::size_t{88};
+    constexpr auto move_record_size = std::size_t{16};
+    constexpr auto summary_record_size = std::size_t{8};
+    constexpr auto game_record_size = std::size_t{32};
+    constexpr auto game_ranking_stats_size = std::size_t{40};
+
+    namespace header_offsets
+    {
+        constexpr auto magic        = std::size_t{0};
+        constexpr auto version      = std::size_t{4};
+        constexpr auto record_count = std::size_t{6};
+        constexpr auto record_size  = std::size_t{8};
+        constexpr auto checksum     = std::size_t{12};
+    }
+
+    namespace record_offsets
+    {
+        constexpr auto stage            = std::size_t{0};
+        constexpr auto hi_score         = std::size_t{4};
+        constexpr auto move_count       = std::size_t{8};
+        constexpr auto time_s           = std::size_t{16};
+        constexpr auto next_input_tiles = std::size_t{24};
+        constexpr auto input_tiles      = std::size_t{28};
+        constexpr auto board_tiles      = std::size_t{32};
+        constexpr auto end              = board_tiles + libgame::data_types::board_tile_matrix::storage_size;
+    }
+
+    namespace summary_record_offsets
+    {
+        constexpr auto stage    = std::size_t{0};
+        constexpr auto flags    = std::size_t{1};
+        constexpr auto hi_score = std::size_t{4};
+    }
+
+    namespace summary_record_flags
+    {
+        constexpr auto last_played = std::uint8_t{1 << 0};
+    }
+
+    namespace journal_header_offsets
+    {
+        constexpr auto magic             = std::size_t{0};
+        constexpr auto version           = std::size_t{4};
+        constexpr auto snapshot_checksum = std::size_t{8};
+    }
+
+    namespace move_record_offsets
+    {
+        constexpr auto col_offset       = std::size_t{0};
+        constexpr auto rotation         = std::size_t{1};
+        constexpr auto next_input_tiles = std::size_t{2};
+        constexpr auto checksum         = std::size_t{6};
+        constexpr auto time_s           = std::size_t{8};
+    }
+
+    namespace game_history_header_offsets
+    {
+        constexpr auto magic       = std::size_t{0};
+        constexpr auto version     = std::size_t{4};
+        constexpr auto first_index = std::size_t{8};
+    }
+
+    namespace game_record_offsets
+    {
+        constexpr auto index          = std::size_t{0};
+        constexpr auto score          = std::size_t{4};
+        constexpr auto time_s         = std::size_t{8};
+        constexpr auto move_count     = std::size_t{16};
+        constexpr auto seed           = std::size_t{20};
+        constexpr auto max_tile_value = std::size_t{24};
+        constexpr auto checksum       = std::size_t{30};
+    }
+
+    namespace game_ranking_stats_offsets
+    {
+        constexpr auto game_count       = std::size_t{0};
+        constexpr auto best_score       = std::size_t{4};
+        constexpr auto total_score      = std::size_t{8};
+        constexpr auto total_move_count = std::size_t{16};
+        constexpr auto total_time_s     = std::size_t{24};
+        constexpr auto best_tile_value  = std::size_t{32};
+    }
+
+    static_assert(libgame::data_types::input_tile_matrix::storage_size == move_record_offsets::checksum - move_record_offsets::next_input_tiles);
+    static_assert(libgame::data_types::input_tile_matrix::storage_size == record_offsets::input_tiles - record_offsets::next_input_tiles);
+    static_assert(libgame::data_types::input_tile_matrix::storage_size == record_offsets::board_tiles - record_offsets::input_tiles);
+    static_assert(record_offsets::end <= record_size);
+
+    constexpr auto tile_value_bit_count = 5;
+    constexpr auto max_tile_value = (1 << tile_value_bit_count) - 1;
+
+    static_assert(std::variant_size_v<data_types::tile> < (1 << (8 - tile_value_bit_count)));
+
+
+
+    /*
+    Little-endian accessors
+    */
+
+    template<class T>
+    T read_uint(const std::byte* pdata)
+    {
+        auto value = T{0};
+        for(auto i = sizeof(T); i > 0; --i)
+        {
+            value = static_cast<T>((value << 8) | std::to_integer<T>(pdata[i - 1]));
+        }
+        return value;
+    }
+
+    template<class T>
+    void write_uint(std::byte* pdata, T value)
+    {
+        for(auto i = std::size_t{0}; i < sizeof(T); ++i)
+        {
+            pdata[i] = static_cast<std::byte>(value & 0xff);
+            value = static_cast<T>(value >> 8);
+        }
+    }
+
+    //Checksum of a record, without its 16-bit checksum field
+    std::uint16_t get_record_checksum
+    (
+        const std::byte* precord,
+        const std::size_t size,
+        const std::size_t checksum_offset
+    )
+    {
+        const auto record = std::span<const std::byte>{precord, size};
+        const auto hash =
+            get_checksum(record.first(checksum_offset)) ^
+            get_checksum(record.subspan(checksum_offset + 2))
+        ;
+        return static_cast<std::uint16_t>((hash >> 16) ^ (hash & 0xffff));
+    }
+
+    std::uint16_t get_move_record_checksum(const std::byte* precord)
+    {
+        return get_record_checksum(precord, move_record_size, move_record_offsets::checksum);
+    }
+
+    std::uint16_t get_game_record_checksum(const std::byte* precord)
+    {
+        return get_record_checksum(precord, game_record_size, game_record_offsets::checksum);
+    }
+
+    void encode_game_record(const data_types::game_record& record, std::byte* precord)
+    {
+        write_uint(precord + game_record_offsets::index, static_cast<std::uint32_t>(record.index));
+        write_uint(precord + game_record_offsets::score, static_cast<std::uint32_t>(record.score));
+        write_uint(precord + game_record_offsets::time_s, std::bit_cast<std::uint64_t>(record.time_s));
+        write_uint(precord + game_record_offsets::move_count, static_cast<std::uint32_t>(record.move_count));
+        write_uint(precord + game_record_offsets::seed, record.seed);
+        write_uint(precord + game_record_offsets::max_tile_value, static_cast<std::uint8_t>(std::clamp(record.max_tile_value, 0, 0xff)));
+        write_uint(precord + game_record_offsets::checksum, get_game_record_checksum(precord));
+    }
+
+    //Return std::nullopt if the checksum doesn't match
+    std::optional<data_types::game_record> decode_game_record(const std::byte* precord)
+    {
+        if(read_uint<std::uint16_t>(precord + game_record_offsets::checksum) != get_game_record_checksum(precord))
+        {
+            return std::nullopt;
+        }
+
+        return data_types::game_record
+        {
+            .index = static_cast<std::int32_t>(read_uint<std::uint32_t>(precord + game_record_offsets::index)),
+            .score = static_cast<std::int32_t>(read_uint<std::uint32_t>(precord + game_record_offsets::score)),
+            .move_count = static_cast<std::int32_t>(read_uint<std::uint32_t>(precord + game_record_offsets::move_count)),
+            .time_s = std::bit_cast<double>(read_uint<std::uint64_t>(precord + game_record_offsets::time_s)),
+            .max_tile_value = read_uint<std::uint8_t>(precord + game_record_offsets::max_tile_value),
+            .seed = read_uint<std::uint32_t>(precord + game_record_offsets::seed)
+        };
+    }
+
+
+
+    /*
+    Tiles
+    */
+
+    int get_tile_value(const libgame::data_types::tiles::number& t)
+    {
+        return t.value;
+    }
+
+    int get_tile_value(const libgame::data_types::tiles::granite& t)
+    {
+        return t.thickness;
+    }
+
+    int get_tile_value(const libgame::data_types::tiles::adder& t)
+    {
+        return t.value;
+    }
+
+    template<class Tile>
+    int get_tile_value(const Tile&)
+    {
+        return 0;
+    }
+
+    void set_tile_value(libgame::data_types::tiles::number& t, const int value)
+    {
+        t.value = value;
+    }
+
+    void set_tile_value(libgame::data_types::tiles::granite& t, const int value)
+    {
+        t.thickness = value;
+    }
+
+    void set_tile_value(libgame::data_types::tiles::adder& t, const int value)
+    {
+        t.value = value;
+    }
+
+    template<class Tile>
+    void set_tile_value(Tile&, const int)
+    {
+    }
+
+    //Return false if the tile can't be represented
+    bool encode_tile(const std::optional<data_types::tile>& opt_tile, std::byte& out)
+    {
+        if(!opt_tile)
+        {
+            out = std::byte{0};
+            return true;
+        }
+
+        const auto value = std::visit
+        (
+            [](const auto& t)
+            {
+                return get_tile_value(t);
+            },
+            *opt_tile
+        );
+
+        if(value < 0 || value > max_tile_value)
+        {
+            return false;
+        }
+
+        const auto type = static_cast<int>(opt_tile->index()) + 1;
+        out = static_cast<std::byte>((type << tile_value_bit_count) | value);
+        return true;
+    }
+
+    template<std::size_t... Is>
+    data_types::tile make_tile(const std::size_t index, std::index_sequence<Is...>)
+    {
+        using tile_factory_t = data_types::tile(*)();
+        constexpr auto factories = std::array<tile_factory_t, sizeof...(Is)>
+        {
+            []{return data_types::tile{std::in_place_index<Is>};}...
+        };
+        return factories[index]();
+    }
+
+    std::optional<data_types::tile> decode_tile(const std::byte in)
+    {
+        const auto byte = std::to_integer<int>(in);
+
+        if(byte == 0)
+        {
+            return std::nullopt;
+        }
+
+        const auto type_index = static_cast<std::size_t>((byte >> tile_value_bit_count) - 1);
+        if(type_index >= std::variant_size_v<data_types::tile>)
+        {
+            throw std::runtime_error{"Invalid tile type: " + std::to_string(type_index)};
+        }
+
+        auto tile = make_tile
+        (
+            type_index,
+            std::make_index_sequence<std::variant_size_v<data_types::tile>>{}
+        );
+
+        std::visit
+        (
+            [&](auto& t)
+            {
+                set_tile_value(t, byte & max_tile_value);
+            },
+            tile
+        );
+
+        return tile;
+    }
+
+    template<class Matrix>
+    bool encode_tiles(const Matrix& tiles, std::byte* pdata)
+    {
+        for(const auto& opt_tile: tiles.data)
+        {
+            if(!encode_tile(opt_tile, *pdata++))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class Matrix>
+    void decode_tiles(const std::byte* pdata, Matrix& tiles)
+    {
+        for(auto& opt_tile: tiles.data)
+        {
+            opt_tile = decode_tile(*pdata++);
+        }
+    }
+
+
+
+    /*
+    Records
+    */
+
+    bool encode_record
+    (
+        const data_types::stage stage,
+        const data_types::stage_state& state,
+        std::byte* pdata
+    )
+    {
+        write_uint(pdata + record_offsets::stage, static_cast<std::uint8_t>(stage));
+        write_uint(pdata + record_offsets::hi_score, static_cast<std::uint32_t>(state.hi_score));
+        write_uint(pdata + record_offsets::move_count, static_cast<std::uint32_t>(state.move_count));
+        write_uint(pdata + record_offsets::time_s, std::bit_cast<std::uint64_t>(state.time_s));
+
+        return
+            encode_tiles(state.next_input_tiles, pdata + record_offsets::next_input_tiles) &&
+            encode_tiles(state.input_tiles, pdata + record_offsets::input_tiles) &&
+            encode_tiles(state.brd.tiles, pdata + record_offsets::board_tiles)
+        ;
+    }
+
+    void decode_record(const std::byte* pdata, data_types::game_state& state)
+    {
+        const auto stage_index = read_uint<std::uint8_t>(pdata + record_offsets::stage);
+        if(stage_index >= data_types::stage_count)
+        {
+            throw std::runtime_error{"Invalid stage: " + std::to_string(stage_index)};
+        }
+
+        auto& stage_state = state.stage_states[static_cast<data_types::stage>(stage_index)];
+
+        stage_state.hi_score = static_cast<std::int32_t>(read_uint<std::uint32_t>(pdata + record_offsets::hi_score));
+        stage_state.move_count = static_cast<std::int32_t>(read_uint<std::uint32_t>(pdata + record_offsets::move_count));
+        stage_state.time_s = std::bit_cast<double>(read_uint<std::uint64_t>(pdata + record_offsets::time_s));
+        decode_tiles(pdata + record_offsets::next_input_tiles, stage_state.next_input_tiles);
+        decode_tiles(pdata + record_offsets::input_tiles, stage_state.input_tiles);
+        decode_tiles(pdata + record_offsets::board_tiles, stage_state.brd.tiles);
+    }
+}
+
+std::uint32_t get_checksum(const std::span<const std::byte> data)
+{
+    auto hash = std::uint32_t{2166136261u};
+    for(const auto b: data)
+    {
+        hash ^= std::to_integer<std::uint32_t>(b);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool is_binary_game_state(const std::span<const std::byte> data)
+{
+    return
+        data.size() >= header_size &&
+        std::memcmp(data.data() + header_offsets::magic, magic.data(), magic.size()) == 0
+    ;
+}
+
+data_types::game_state from_binary(const std::span<const std::byte> data)
+{
+    if(!is_binary_game_state(data))
+    {
+        throw std::runtime_error{"Not a binary game state"};
+    }
+
+    const auto version = read_uint<std::uint16_t>(data.data() + header_offsets::version);
+    if(version != binary_format_version)
+    {
+        throw std::runtime_error{"Unsupported binary format version: " + std::to_string(version)};
+    }
+
+    const auto record_count = std::size_t{read_uint<std::uint16_t>(data.data() + header_offsets::record_count)};
+    const auto actual_record_size = std::size_t{read_uint<std::uint32_t>(data.data() + header_offsets::record_size)};
+    if(actual_record_size != record_size || data.size() != header_size + record_count * record_size)
+    {
+        throw std::runtime_error{"Invalid binary game state size"};
+    }
+
+    const auto records = data.subspan(header_size);
+    if(get_checksum(records) != read_uint<std::uint32_t>(data.data() + header_offsets::checksum))
+    {
+        throw std::runtime_error{"Invalid binary game state checksum"};
+    }
+
+    auto state = data_types::game_state{};
+    for(auto i = std::size_t{0}; i < record_count; ++i)
+    {
+        decode_record(records.data() + i * record_size, state);
+    }
+    return state;
+}
+
+std::optional<std::vector<std::byte>> to_binary(const data_types::game_state& state)
+{
+    const auto record_count = state.stage_states.size();
+    auto data = std::vector<std::byte>(header_size + record_count * record_size);
+
+    auto precord = data.data() + header_size;
+    for(const auto& [stage, stage_state]: state.stage_states)
+    {
+        if(!encode_record(stage, stage_state, precord))
+        {
+            return std::nullopt;
+        }
+        precord += record_size;
+    }
+
+    std::memcpy(data.data() + header_offsets::magic, magic.data(), magic.size());
+    write_uint(data.data() + header_offsets::version, static_cast<std::uint16_t>(binary_format_version));
+    write_uint(data.data() + header_offsets::record_count, static_cast<std::uint16_t>(record_count));
+    write_uint(data.data() + header_offsets::record_size, static_cast<std::uint32_t>(record_size));
+    write_uint
+    (
+        data.data() + header_offsets::checksum,
+        get_checksum(std::span<const std::byte>{data}.subspan(header_size))
+    );
+
+    return data;
+}
+
+std::vector<std::byte> to_binary(const stage_index& index)
+{
+    const auto& summaries = index.summaries;
+    const auto record_count = summaries.size();
+    auto data = std::vector<std::byte>(header_size + record_count * summary_record_size);
+
+    auto precord = data.data() + header_size;
+    for(const auto& [stage, summary]: summaries)
+    {
+        const auto flags = index.opt_last_played_stage == stage ? summary_record_flags::last_played : std::uint8_t{0};
+        write_uint(precord + summary_record_offsets::stage, static_cast<std::uint8_t>(stage));
+        write_uint(precord + summary_record_offsets::flags, flags);
+        write_uint(precord + summary_record_offsets::hi_score, static_cast<std::uint32_t>(summary.hi_score));
+        precord += summary_record_size;
+    }
+
+    std::memcpy(data.data() + header_offsets::magic, index_magic.data(), index_magic.size());
+    write_uint(data.data() + header_offsets::version, static_cast<std::uint16_t>(index_format_version));
+    write_uint(data.data() + header_offsets::record_count, static_cast<std::uint16_t>(record_count));
+    write_uint(data.data() + header_offsets::record_size, static_cast<std::uint32_t>(summary_record_size));
+    write_uint
+    (
+        data.data() + header_offsets::checksum,
+        get_checksum(std::span<const std::byte>{data}.subspan(header_size))
+    );
+
+    return data;
+}
+
+std::optional<stage_index> stage_index_from_binary(const std::span<const std::byte> data)
+{
+    if
+    (
+        data.size() < header_size ||
+        std::memcmp(data.data() + header_offsets::magic, index_magic.data(), index_magic.size()) != 0 ||
+        read_uint<std::uint16_t>(data.data() + header_offsets::version) != index_format_version ||
+        read_uint<std::uint32_t>(data.data() + header_offsets::record_size) != summary_record_size
+    )
+    {
+        return std::nullopt;
+    }
+
+    const auto record_count = std::size_t{read_uint<std::uint16_t>(data.data() + header_offsets::record_count)};
+    const auto records = data.subspan(header_size);
+    if
+    (
+        records.size() != record_count * summary_record_size ||
+        get_checksum(records) != read_uint<std::uint32_t>(data.data() + header_offsets::checksum)
+    )
+    {
+        return std::nullopt;
+    }
+
+    auto index = stage_index{};
+    for(auto i = std::size_t{0}; i < record_count; ++i)
+    {
+        const auto precord = records.data() + i * summary_record_size;
+
+        const auto stage_value = read_uint<std::uint8_t>(precord + summary_record_offsets::stage);
+        if(stage_value >= data_types::stage_count)
+        {
+            return std::nullopt;
+        }
+
+        const auto stage = static_cast<data_types::stage>(stage_value);
+
+        index.summaries[stage].hi_score =
+            static_cast<std::int32_t>(read_uint<std::uint32_t>(precord + summary_record_offsets::hi_score))
+        ;
+
+        if(read_uint<std::uint8_t>(precord + summary_record_offsets::flags) & summary_record_flags::last_played)
+        {
+            index.opt_last_played_stage = stage;
+        }
+    }
+
+    return index;
+}
+
+std::vector<std::byte> make_journal_header(const std::span<const std::byte> snapshot)
+{
+    auto data = std::vector<std::byte>(header_size);
+    std::memcpy(data.data() + journal_header_offsets::magic, journal_magic.data(), journal_magic.size());
+    write_uint(data.data() + journal_header_offsets::version, static_cast<std::uint16_t>(journal_format_version));
+    write_uint(data.data() + journal_header_offsets::snapshot_checksum, get_checksum(snapshot));
+    return data;
+}
+
+std::optional<std::vector<std::byte>> to_binary(const journal_move& move)
+{
+    auto data = std::vector<std::byte>(move_record_size);
+    const auto pdata = data.data();
+
+    if
+    (
+        move.layout.col_offset < 0 || move.layout.col_offset > 0xff ||
+        move.layout.rotation < 0 || move.layout.rotation > 0xff ||
+        !encode_tiles(move.next_input_tiles, pdata + move_record_offsets::next_input_tiles)
+    )
+    {
+        return std::nullopt;
+    }
+
+    write_uint(pdata + move_record_offsets::col_offset, static_cast<std::uint8_t>(move.layout.col_offset));
+    write_uint(pdata + move_record_offsets::rotation, static_cast<std::uint8_t>(move.layout.rotation));
+    write_uint(pdata + move_record_offsets::time_s, std::bit_cast<std::uint64_t>(move.time_s));
+    write_uint(pdata + move_record_offsets::checksum, get_move_record_checksum(pdata));
+
+    return data;
+}
+
+std::optional<journal> journal_from_binary(const std::span<const std::byte> data)
+{
+    if
+    (
+        data.size() < header_size ||
+        std::memcmp(data.data() + journal_header_offsets::magic, journal_magic.data(), journal_magic.size()) != 0 ||
+        read_uint<std::uint16_t>(data.data() + journal_header_offsets::version) != journal_format_version
+    )
+    {
+        return std::nullopt;
+    }
+
+    auto jnl = journal{};
+    jnl.snapshot_checksum = read_uint<std::uint32_t>(data.data() + journal_header_offsets::snapshot_checksum);
+
+    const auto records = data.subspan(header_size);
+    const auto record_count = records.size() / move_record_size;
+    jnl.moves.reserve(record_count);
+
+    for(auto i = std::size_t{0}; i < record_count; ++i)
+    {
+        const auto precord = records.data() + i * move_record_size;
+
+        if(read_uint<std::uint16_t>(precord + move_record_offsets::checksum) != get_move_record_checksum(precord))
+        {
+            break;
+        }
+
+        try
+        {
+            auto& move = jnl.moves.emplace_back();
+            move.layout.col_offset = read_uint<std::uint8_t>(precord + move_record_offsets::col_offset);
+            move.layout.rotation = read_uint<std::uint8_t>(precord + move_record_offsets::rotation);
+            move.time_s = std::bit_cast<double>(read_uint<std::uint64_t>(precord + move_record_offsets::time_s));
+            decode_tiles(precord + move_record_offsets::next_input_tiles, move.next_input_tiles);
+        }
+        catch(...)
+        {
+            jnl.moves.pop_back();
+            break;
+        }
+    }
+
+    jnl.intact = records.size() == jnl.moves.size() * move_record_size;
+
+    return jnl;
+}
+
+std::vector<std::byte> make_game_history_header(const int first_index)
+{
+    auto data = std::vector<std::byte>(header_size);
+    std::memcpy(data.data() + game_history_header_offsets::magic, game_history_magic.data(), game_history_magic.size());
+    write_uint(data.data() + game_history_header_offsets::version, static_cast<std::uint16_t>(game_history_format_version));
+    write_uint(data.data() + game_history_header_offsets::first_index, static_cast<std::uint32_t>(first_index));
+    return data;
+}
+
+std::vector<std::byte> to_binary(const data_types::game_record& record)
+{
+    auto data = std::vector<std::byte>(game_record_size);
+    encode_game_record(record, data.data());
+    return data;
+}
+
+std::optional<game_history_segment> game_history_from_binary(const std::span<const std::byte> data)
+{
+    if
+    (
+        data.size() < header_size ||
+        std::memcmp(data.data() + game_history_header_offsets::magic, game_history_magic.data(), game_history_magic.size()) != 0 ||
+        read_uint<std::uint16_t>(data.data() + game_history_header_offsets::version) != game_history_format_version
+    )
+    {
+        return std::nullopt;
+    }
+
+    const auto records = data.subspan(header_size);
+    const auto record_count = records.size() / game_record_size;
+
+    auto segment = game_history_segment{};
+    segment.games.reserve(record_count);
+
+    for(auto i = std::size_t{0}; i < record_count; ++i)
+    {
+        const auto opt_record = decode_game_record(records.data() + i * game_record_size);
+        if(!opt_record)
+        {
+            break;
+        }
+        segment.games.push_back(*opt_record);
+    }
+
+    segment.intact = records.size() == segment.games.size() * game_record_size;
+
+    return segment;
+}
+
+std::vector<std::byte> to_binary(const data_types::game_ranking& ranking)
+{
+    const auto record_count = ranking.best_games.size();
+    auto data = std::vector<std::byte>(header_size + game_ranking_stats_size + record_count * game_record_size);
+
+    const auto pstats = data.data() + header_size;
+    const auto& stats = ranking.stats;
+    write_uint(pstats + game_ranking_stats_offsets::game_count, static_cast<std::uint32_t>(stats.game_count));
+    write_uint(pstats + game_ranking_stats_offsets::best_score, static_cast<std::uint32_t>(stats.best_score));
+    write_uint(pstats + game_ranking_stats_offsets::total_score, static_cast<std::uint64_t>(stats.total_score));
+    write_uint(pstats + game_ranking_stats_offsets::total_move_count, static_cast<std::uint64_t>(stats.total_move_count));
+    write_uint(pstats + game_ranking_stats_offsets::total_time_s, std::bit_cast<std::uint64_t>(stats.total_time_s));
+    write_uint(pstats + game_ranking_stats_offsets::best_tile_value, static_cast<std::uint32_t>(stats.best_tile_value));
+
+    auto precord = pstats + game_ranking_stats_size;
+    for(const auto& record: ranking.best_games)
+    {
+        encode_game_record(record, precord);
+        precord += game_record_size;
+    }
+
+    std::memcpy(data.data() + header_offsets::magic, game_ranking_magic.data(), game_ranking_magic.size());
+    write_uint(data.data() + header_offsets::version, static_cast<std::uint16_t>(game_ranking_format_version));
+    write_uint(data.data() + header_offsets::record_count, static_cast<std::uint16_t>(record_count));
+    write_uint(data.data() + header_offsets::record_size, static_cast<std::uint32_t>(game_record_size));
+    write_uint
+    (
+        data.data() + header_offsets::checksum,
+        get_checksum(std::span<const std::byte>{data}.subspan(header_size))
+    );
+
+    return data;
+}
+
+std::optional<data_types::game_ranking> game_ranking_from_binary(const std::span<const std::byte> data)
+{
+    if
+    (
+        data.size() < header_size + game_ranking_stats_size ||
+        std::memcmp(data.data() + header_offsets::magic, game_ranking_magic.data(), game_ranking_magic.size()) != 0 ||
+        read_uint<std::uint16_t>(data.data() + header_offsets::version) != game_ranking_format_version ||
+        read_uint<std::uint32_t>(data.data() + header_offsets::record_size) != game_record_size
+    )
+    {
+        return std::nullopt;
+    }
+
+    const auto record_count = std::size_t{read_uint<std::uint16_t>(data.data() + header_offsets::record_count)};
+    const auto body = data.subspan(header_size);
+    if
+    (
+        body.size() != game_ranking_stats_size + record_count * game_record_size ||
+        get_checksum(body) != read_uint<std::uint32_t>(data.data() + header_offsets::checksum)
+    )
+    {
+        return std::nullopt;
+    }
+
+    auto ranking = data_types::game_ranking{};
+
+    const auto pstats = body.data();
+    auto& stats = ranking.stats;
+    stats.game_count = static_cast<std::int32_t>(read_uint<std::uint32_t>(pstats + game_ranking_stats_offsets::game_count));
+    stats.best_score = static_cast<std::int32_t>(read_uint<std::uint32_t>(pstats + game_ranking_stats_offsets::best_score));
+    stats.total_score = static_cast<std::int64_t>(read_uint<std::uint64_t>(pstats + game_ranking_stats_offsets::total_score));
+    stats.total_move_count = static_cast<std::int64_t>(read_uint<std::uint64_t>(pstats + game_ranking_stats_offsets::total_move_count));
+    stats.total_time_s = std::bit_cast<double>(read_uint<std::uint64_t>(pstats + game_ranking_stats_offsets::total_time_s));
+    stats.best_tile_value = static_cast<std::int32_t>(read_uint<std::uint32_t>(pstats + game_ranking_stats_offsets::best_tile_value));
+
+    ranking.best_games.reserve(record_count);
+    for(auto i = std::size_t{0}; i < record_count; ++i)
+    {
+        const auto opt_record = decode_game_record(pstats + game_ranking_stats_size + i * game_record_size);
+        if(!opt_record)
+        {
+            return std::nullopt;
+        }
+        ranking.best_games.push_back(*opt_record);
+    }
+
+    return ranking;
+}
+
+} //namespace
@@ -0,0 +1,219 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDB_BINARY_CONVERSION_HPP
+#define LIBDB_BINARY_CONVERSION_HPP
+
+#include <libdb/data_types.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+/*
+Binary save format.
+
+Little-endian. All the records have the same size.
+
+Header (16 bytes):
+    [0]  magic "TRNR"
+    [4]  u16 version
+    [6]  u16 record count
+    [8]  u32 record size
+    [12] u32 FNV-1a checksum of the records
+
+Stage state record (88 bytes):
+    [0]  u8 stage
+    [1]  3 reserved bytes
+    [4]  i32 hi score
+    [8]  i32 move count
+    [12] 4 reserved bytes
+    [16] f64 time in seconds
+    [24] 4 next input tiles
+    [28] 4 input tiles
+    [32] 54 board tiles
+    [86] 2 reserved bytes
+
+Tiles are stored in matrix storage order, one byte each:
+    0 for no tile, otherwise (variant index + 1) << 5 | value
+where value is the number value, the granite thickness or the adder value
+(from 0 to 31).
+
+Stage index header (16 bytes):
+    [0]  magic "TRNI"
+    [4]  u16 version
+    [6]  u16 record count
+    [8]  u32 record size
+    [12] u32 FNV-1a checksum of the records
+
+Stage summary record (8 bytes):
+    [0]  u8 stage
+    [1]  u8 flags (bit 0: last played stage)
+    [2]  2 reserved bytes
+    [4]  i32 hi score
+
+Move journal header (16 bytes):
+    [0]  magic "TRNJ"
+    [4]  u16 version
+    [6]  2 reserved bytes
+    [8]  u32 checksum of the snapshot entry the moves apply to
+    [12] 4 reserved bytes
+
+Move record (16 bytes), appended to the header:
+    [0]  u8 input layout column offset
+    [1]  u8 input layout rotation
+    [2]  4 resulting next input tiles
+    [6]  u16 FNV-1a checksum of the other bytes of the record, folded
+    [8]  f64 time in seconds after the move
+
+Game history segment header (16 bytes):
+    [0]  magic "TRNH"
+    [4]  u16 version
+    [6]  2 reserved bytes
+    [8]  u32 index of the first game of the segment
+    [12] 4 reserved bytes
+
+Game record (32 bytes), appended to a game history segment header:
+    [0]  u32 index of the game
+    [4]  i32 score
+    [8]  f64 time in seconds
+    [16] i32 move count
+    [20] u32 seed
+    [24] u8 max tile value
+    [25] 5 reserved bytes
+    [30] u16 FNV-1a checksum of the other bytes of the record, folded
+
+Game ranking header (16 bytes):
+    [0]  magic "TRNK"
+    [4]  u16 version
+    [6]  u16 record count
+    [8]  u32 record size
+    [12] u32 FNV-1a checksum of the stats and the records
+
+Game ranking stats (40 bytes), followed by the best game records:
+    [0]  i32 game count
+    [4]  i32 best score
+    [8]  i64 total score
+    [16] i64 total move count
+    [24] f64 total time in seconds
+    [32] i32 best tile value
+    [36] 4 reserved bytes
+*/
+
+namespace libdb
+{
+    constexpr int binary_format_version = 3;
+    constexpr int journal_format_version = 1;
+    constexpr int index_format_version = 1;
+    constexpr int game_history_format_version = 1;
+    constexpr int game_ranking_format_version = 1;
+
+    struct journal_move
+    {
+        libgame::data_types::input_layout layout;
+        libgame::data_types::input_tile_matrix next_input_tiles;
+        double time_s = 0;
+    };
+
+    //Content of the stage index entry
+    struct stage_index
+    {
+        data_types::stage_summary_map summaries;
+        std::optional<data_types::stage> opt_last_played_stage;
+    };
+
+    struct game_history_segment
+    {
+        std::vector<data_types::game_record> games;
+
+        //Whether the data ends right after the last valid record
+        bool intact = true;
+    };
+
+    struct journal
+    {
+        std::uint32_t snapshot_checksum = 0;
+        std::vector<journal_move> moves;
+
+        //Whether the data ends right after the last valid move
+        bool intact = true;
+    };
+
+    //FNV-1a
+    std::uint32_t get_checksum(std::span<const std::byte> data);
+
+    //Check the magic number of given data
+    bool is_binary_game_state(std::span<const std::byte> data);
+
+    /*
+    Decode given data, without any intermediate copy.
+    Throw if data is invalid.
+    */
+    data_types::game_state from_binary(std::span<const std::byte> data);
+
+    /*
+    Encode given state.
+    Return std::nullopt if a tile value can't be represented.
+    */
+    std::optional<std::vector<std::byte>> to_binary(const data_types::game_state& state);
+
+    std::vector<std::byte> to_binary(const stage_index& index);
+
+    //Return std::nullopt if data is invalid
+    std::optional<stage_index> stage_index_from_binary(std::span<const std::byte> data);
+
+    //Header of a journal whose moves apply to the given snapshot entry
+    std::vector<std::byte> make_journal_header(std::span<const std::byte> snapshot);
+
+    /*
+    Encode given move.
+    Return std::nullopt if a tile value can't be represented.
+    */
+    std::optional<std::vector<std::byte>> to_binary(const journal_move& move);
+
+    /*
+    Decode given journal.
+    Return std::nullopt if the header is invalid.
+    Decoding stops at the first invalid or incomplete record, which is what
+    an interrupted append leaves behind. Records written after such garbage
+    are unreachable, so a journal that isn't intact must not be appended to.
+    */
+    std::optional<journal> journal_from_binary(std::span<const std::byte> data);
+
+    //Header of a game history segment starting with the given game
+    std::vector<std::byte> make_game_history_header(int first_index);
+
+    std::vector<std::byte> to_binary(const data_types::game_record& record);
+
+    /*
+    Decode given game history segment.
+    Return std::nullopt if the header is invalid.
+    Like journal_from_binary(), stop at the first invalid or incomplete
+    record.
+    */
+    std::optional<game_history_segment> game_history_from_binary(std::span<const std::byte> data);
+
+    std::vector<std::byte> to_binary(const data_types::game_ranking& ranking);
+
+    //Return std::nullopt if data is invalid
+    std::optional<data_types::game_ranking> game_ranking_from_binary(std::span<const std::byte> data);
+}
+
+#endif
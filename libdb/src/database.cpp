@@ -17,14 +17,25 @@ You should have received a copy of the GNU General Public License
 along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "binary_conversion.hpp"
+#include "game_history.hpp"
 #include "json_conversion.hpp"
+#include "json_sax_reader.hpp"
+#include "metering_storage_backend.hpp"
+#include "persistence_queue.hpp"
+#ifdef __EMSCRIPTEN__
 #include "indexed_db.hpp"
+#endif
 #include <libdb/database.hpp>
 #include <nlohmann/json.hpp>
 #include <libutil/log.hpp>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <map>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace libdb
 {
@@ -32,6 +43,15 @@ namespace libdb
 namespace
 {
     constexpr int current_version = 2;
+
+    //Moves played in a row are coalesced into a single write
+    constexpr auto write_debounce_delay = std::chrono::milliseconds{500};
+
+    //Pending writes are forced after that delay, even if moves keep coming
+    constexpr auto write_max_delay = std::chrono::seconds{2};
+
+    //Number of moves after which a journal is compacted into a new snapshot
+    constexpr auto journal_snapshot_interval = 32;
 }
 
 struct database::impl
@@ -40,58 +60,279 @@ struct database::impl
         impl
         (
             const bool fail_on_access_error,
-            const event_handler& evt_handler
+            const event_handler& evt_handler,
+            std::unique_ptr<storage_backend>&& pbackend
         ):
             fail_on_access_error_(fail_on_access_error),
-            event_handler_(evt_handler)
-        {
-            indexed_db::async_read_v2
+            event_handler_(evt_handler),
+            backend_
+            (
+                std::move(pbackend),
+                [this](const events::read_metrics& metrics)
+                {
+                    event_handler_(metrics);
+                }
+            ),
+            write_queue_
             (
+                backend_,
                 "ternarii",
-                "game_state",
-                [this](void* data, int size)
+                write_debounce_delay,
+                write_max_delay,
+                [this](const std::string& key, const char* error)
                 {
-                    if(data && size != 0)
-                    {
-                        auto json_str = std::string_view
-                        {
-                            reinterpret_cast<char*>(data),
-                            static_cast<std::string_view::size_type>(size)
-                        };
-                        libutil::log::info("Loaded data from \"ternarii\" IndexedDB database: ", json_str);
-                        load_from_idb(json_str, current_version);
-                    }
-                    else
-                    {
-                        async_read_database_v1();
-                    }
+                    //We don't know what the journals apply to anymore
+                    journal_lengths_.clear();
+                    game_history_.on_write_failure();
+
+                    libutil::log::error("Write error (", key, "): ", error);
+                    if(fail_on_access_error_)
+                        throw std::runtime_error{std::string{"Write error: "} + error};
                 },
-                [this]()
+                [this](const events::write_metrics& metrics)
                 {
-                    async_read_database_v1();
+                    event_handler_(metrics);
                 }
+            ),
+            game_history_(backend_, write_queue_, "ternarii")
+        {
+            async_read_index();
+        }
+
+        ~impl()
+        {
+            try
+            {
+                flush();
+            }
+            catch(const std::exception& e)
+            {
+                libutil::log::error("Flush error: ", e.what());
+            }
+        }
+
+        void advance()
+        {
+            backend_.poll();
+            write_queue_.advance();
+        }
+
+        void flush()
+        {
+            //Complete the writes right away if the backend can (including
+            //the ones of the games waiting for their ranking to be loaded)
+            do
+            {
+                write_queue_.flush();
+            } while
+            (
+                (!write_queue_.is_idle() || game_history_.is_loading()) &&
+                backend_.wait()
             );
+        }
+
+        const data_types::stage_summary_map& get_stage_summaries() const
+        {
+            return index_.summaries;
+        }
 
+        std::optional<data_types::stage> get_last_played_stage() const
+        {
+            return index_.opt_last_played_stage;
         }
 
-        const std::optional<data_types::game_state>& get_game_state() const
+        void prefetch_stage_state(const data_types::stage stage)
         {
-            return opt_game_state_;
+            async_get_stage_state(stage, [](const data_types::stage_state*){});
+        }
+
+        void async_get_stage_state(const data_types::stage stage, const stage_state_callback& callback)
+        {
+            if(loaded_stages_.contains(stage))
+            {
+                callback(find_stage_state(stage));
+                return;
+            }
+
+            auto& callbacks = pending_loads_[stage];
+            callbacks.push_back(callback);
+
+            //Load already in progress
+            if(callbacks.size() > 1)
+            {
+                return;
+            }
+
+            async_load_stage_state
+            (
+                stage,
+                [this, stage](std::optional<data_types::stage_state>&& opt_state)
+                {
+                    on_stage_state_loaded(stage, std::move(opt_state));
+                }
+            );
+        }
+
+        const data_types::stage_state* find_stage_state(const data_types::stage stage) const
+        {
+            const auto it = stage_states_.find(stage);
+            return it != stage_states_.end() ? &it->second : nullptr;
         }
 
         void set_stage_state(const data_types::stage stage, const data_types::stage_state& state)
         {
-            if(!opt_game_state_)
-                opt_game_state_ = data_types::game_state{};
+            stage_states_[stage] = state;
+            loaded_stages_.insert(stage);
+            set_last_played_stage(stage);
+
+            write_snapshot(stage);
+        }
+
+        void add_move
+        (
+            const data_types::stage stage,
+            const libgame::data_types::input_layout& layout,
+            const data_types::stage_state& state
+        )
+        {
+            stage_states_[stage] = state;
+            loaded_stages_.insert(stage);
+            set_last_played_stage(stage);
+
+            const auto journal_length_it = journal_lengths_.find(stage);
+            if
+            (
+                backend_.has_native_append() &&
+                journal_length_it != journal_lengths_.end() &&
+                journal_length_it->second < journal_snapshot_interval &&
+                !is_overflowed(state.brd)
+            )
+            {
+                const auto move = journal_move
+                {
+                    .layout = layout,
+                    .next_input_tiles = state.next_input_tiles,
+                    .time_s = state.time_s
+                };
+
+                if(const auto opt_data = to_binary(move))
+                {
+                    write_queue_.push_append(get_journal_key(stage), *opt_data);
+                    ++journal_length_it->second;
+                    update_summary(stage);
+                    return;
+                }
+            }
+
+            write_snapshot(stage);
+        }
 
-            opt_game_state_->stage_states[stage] = state;
+        void add_finished_game(const data_types::stage stage, const data_types::game_record& record)
+        {
+            game_history_.add_game(stage, record);
+        }
 
-            save_data();
+        void async_get_game_ranking(const data_types::stage stage, const game_ranking_callback& callback)
+        {
+            game_history_.async_get_ranking(stage, callback);
         }
 
     private:
+        using load_callback = std::function<void(std::optional<data_types::stage_state>&&)>;
+
+        /*
+        Loading sequence:
+        1. Stage index, under the "stage_index" key. If it's there, loading
+           ends here, and stage states are loaded on demand (see 3 and 4).
+           Otherwise:
+        2. Whole game state, as saved by previous versions (JSON or binary),
+           under the "game_state" key (or in the v1 database if there isn't
+           any);
+        3. Stage state snapshots, under the "stage_state_<index>" keys, which
+           override the ones of step 2;
+        4. Move journals, under the "stage_journal_<index>" keys, which are
+           replayed on top of the snapshots they refer to.
+        Stage states loaded from step 2 are then saved under their own key,
+        and so is the stage index.
+        */
+
+        void async_read_index()
+        {
+            backend_.async_read
+            (
+                "ternarii",
+                "stage_index",
+                [this](const void* data, int size)
+                {
+                    auto opt_index = stage_index_from_binary
+                    (
+                        std::span
+                        {
+                            static_cast<const std::byte*>(data),
+                            static_cast<std::size_t>(data ? size : 0)
+                        }
+                    );
+
+                    if(opt_index)
+                    {
+                        index_ = std::move(*opt_index);
+                        event_handler_(events::end_of_loading{});
+                    }
+                    else
+                    {
+                        async_read_game_state();
+                    }
+                },
+                [this](const char* error)
+                {
+                    libutil::log::error("Read error: ", error);
+                    async_read_game_state();
+                }
+            );
+        }
+
+        void async_read_game_state()
+        {
+            backend_.async_read
+            (
+                "ternarii",
+                "game_state",
+                [this](const void* data, int size)
+                {
+                    if(data && size != 0)
+                    {
+                        libutil::log::info("Loaded ", size, " bytes from \"game_state\" entry");
+
+                        //Skip the invalid entry, but keep loading the
+                        //stage states
+                        try
+                        {
+                            merge_legacy(decode_game_state(data, size));
+                        }
+                        catch(const std::exception& e)
+                        {
+                            libutil::log::error("Invalid \"game_state\" entry: ", e.what());
+                        }
+
+                        async_read_stage_states();
+                    }
+                    else
+                    {
+                        async_read_database_v1();
+                    }
+                },
+                [this](const char* error)
+                {
+                    libutil::log::error("Read error: ", error);
+                    async_read_database_v1();
+                }
+            );
+        }
+
+        //Only IndexedDB has a v1 database to migrate from
         void async_read_database_v1()
         {
+#ifdef __EMSCRIPTEN__
             indexed_db::async_read
             (
                 "database",
@@ -107,12 +348,16 @@ struct database::impl
                             static_cast<std::string_view::size_type>(size)
                         };
                         libutil::log::info("Loaded data from \"database\" IndexedDB database: ", json_str);
-                        load_from_idb(json_str, current_version);
-                    }
-                    else
-                    {
-                        event_handler_(events::end_of_loading{});
+                        try
+                        {
+                            merge_legacy(decode_json_game_state(json_str));
+                        }
+                        catch(const std::exception& e)
+                        {
+                            libutil::log::error("Invalid \"database\" IndexedDB database: ", e.what());
+                        }
                     }
+                    async_read_stage_states();
                 },
                 [this](const char* error)
                 {
@@ -121,70 +366,394 @@ struct database::impl
                         throw std::runtime_error{std::string{"IndexedDB read error: "} + error};
                 }
             );
+#else
+            async_read_stage_states();
+#endif
+        }
+
+        void merge_legacy(data_types::game_state&& state)
+        {
+            for(auto& [stage, stage_state]: state.stage_states)
+            {
+                stage_states_[stage] = std::move(stage_state);
+            }
         }
 
-        void load_from_idb(const std::string_view json_str, const int json_version)
+        //Load all the stage states, then build the index
+        void async_read_stage_states()
         {
-            //Parse JSON string
-            const auto json = nlohmann::json::parse(json_str);
+            pending_read_count_ = data_types::stage_count;
 
-            //Convert JSON to state
-            auto game_state = data_types::game_state{};
-            from_json(json, game_state, json_version);
-            opt_game_state_ = game_state;
+            for(auto i = 0; i < data_types::stage_count; ++i)
+            {
+                const auto stage = static_cast<data_types::stage>(i);
+
+                async_load_stage_state
+                (
+                    stage,
+                    [this, stage](std::optional<data_types::stage_state>&& opt_state)
+                    {
+                        if(opt_state)
+                        {
+                            stage_states_[stage] = std::move(*opt_state);
+                        }
+
+                        if(--pending_read_count_ == 0)
+                        {
+                            on_all_stage_states_loaded();
+                        }
+                    }
+                );
+            }
+        }
+
+        void on_all_stage_states_loaded()
+        {
+            //Stage states from the legacy entries don't have their own entry
+            //yet
+            for(const auto& [stage, stage_state]: stage_states_)
+            {
+                write_snapshot(stage);
+            }
+
+            for(auto i = 0; i < data_types::stage_count; ++i)
+            {
+                loaded_stages_.insert(static_cast<data_types::stage>(i));
+            }
+
+            write_index();
 
             event_handler_(events::end_of_loading{});
         }
 
-        void save_data()
+        /*
+        Load the snapshot of the given stage and replay its journal.
+        Call callback with std::nullopt if there's no snapshot.
+        */
+        void async_load_stage_state(const data_types::stage stage, const load_callback& callback)
         {
-            try
+            backend_.async_read
+            (
+                "ternarii",
+                get_stage_state_key(stage).c_str(),
+                [this, stage, callback](const void* data, int size)
+                {
+                    if(!data || size == 0)
+                    {
+                        callback(std::nullopt);
+                        return;
+                    }
+
+                    auto state = data_types::game_state{};
+                    try
+                    {
+                        state = decode_game_state(data, size);
+                    }
+                    catch(const std::exception& e)
+                    {
+                        libutil::log::error("Invalid state of stage ", static_cast<int>(stage), ": ", e.what());
+                        callback(std::nullopt);
+                        return;
+                    }
+
+                    const auto stage_state_it = state.stage_states.find(stage);
+                    if(stage_state_it == state.stage_states.end())
+                    {
+                        callback(std::nullopt);
+                        return;
+                    }
+
+                    const auto bytes = std::span
+                    {
+                        static_cast<const std::byte*>(data),
+                        static_cast<std::size_t>(size)
+                    };
+
+                    async_read_journal
+                    (
+                        stage,
+                        std::make_shared<data_types::stage_state>(std::move(stage_state_it->second)),
+                        get_checksum(bytes),
+                        callback
+                    );
+                },
+                [callback](const char* error)
+                {
+                    libutil::log::error("Read error: ", error);
+                    callback(std::nullopt);
+                }
+            );
+        }
+
+        void async_read_journal
+        (
+            const data_types::stage stage,
+            const std::shared_ptr<data_types::stage_state>& pstate,
+            const std::uint32_t snapshot_checksum,
+            const load_callback& callback
+        )
+        {
+            backend_.async_read
+            (
+                "ternarii",
+                get_journal_key(stage).c_str(),
+                [this, stage, pstate, snapshot_checksum, callback](const void* data, int size)
+                {
+                    const auto opt_journal = journal_from_binary
+                    (
+                        std::span
+                        {
+                            static_cast<const std::byte*>(data),
+                            static_cast<std::size_t>(data ? size : 0)
+                        }
+                    );
+
+                    //Ignore journals that don't apply to the snapshot
+                    //(typically because the application was closed between
+                    //the write of the snapshot and the write of the new
+                    //journal)
+                    if(opt_journal && opt_journal->snapshot_checksum == snapshot_checksum)
+                    {
+                        libutil::log::info("Replaying ", opt_journal->moves.size(), " move(s) of stage ", static_cast<int>(stage));
+                        replay(stage, *opt_journal, *pstate);
+
+                        //Unless the stage has been modified in the meantime,
+                        //keep appending to the journal. Moves appended after
+                        //a torn record would be lost: in that case, let the
+                        //next move write a snapshot instead.
+                        if(opt_journal->intact && !loaded_stages_.contains(stage))
+                        {
+                            journal_lengths_[stage] = static_cast<int>(opt_journal->moves.size());
+                        }
+                    }
+
+                    callback(std::move(*pstate));
+                },
+                [pstate, callback](const char* error)
+                {
+                    libutil::log::error("Read error: ", error);
+                    callback(std::move(*pstate));
+                }
+            );
+        }
+
+        void on_stage_state_loaded(const data_types::stage stage, std::optional<data_types::stage_state>&& opt_state)
+        {
+            //Ignore the loaded state if the stage has been modified in the
+            //meantime
+            if(!loaded_stages_.contains(stage))
+            {
+                loaded_stages_.insert(stage);
+
+                if(opt_state)
+                {
+                    //Keep the index up to date, in case it hasn't been
+                    //written after the last snapshot
+                    auto& summary = index_.summaries[stage];
+                    if(summary.hi_score != opt_state->hi_score)
+                    {
+                        summary.hi_score = opt_state->hi_score;
+                        write_index();
+                    }
+
+                    stage_states_[stage] = std::move(*opt_state);
+                }
+            }
+
+            auto callbacks = std::move(pending_loads_[stage]);
+            pending_loads_.erase(stage);
+
+            const auto pstate = find_stage_state(stage);
+            for(const auto& callback: callbacks)
+            {
+                callback(pstate);
+            }
+        }
+
+        static void replay
+        (
+            const data_types::stage stage,
+            const journal& jnl,
+            data_types::stage_state& state
+        )
+        {
+            if(jnl.moves.empty())
+            {
+                return;
+            }
+
+            auto game = libgame::game{stage, state};
+            auto events = libgame::event_list{};
+            for(const auto& move: jnl.moves)
+            {
+                game.replay_input_tiles_drop(move.layout, move.next_input_tiles, events);
+                events.clear();
+            }
+
+            state = game.get_state();
+            state.time_s = jnl.moves.back().time_s;
+        }
+
+        static data_types::game_state decode_game_state(const void* data, const int size)
+        {
+            const auto bytes = std::span
+            {
+                static_cast<const std::byte*>(data),
+                static_cast<std::size_t>(size)
+            };
+
+            if(is_binary_game_state(bytes))
+            {
+                return from_binary(bytes);
+            }
+
+            const auto json_str = std::string_view
+            {
+                static_cast<const char*>(data),
+                static_cast<std::string_view::size_type>(size)
+            };
+            return decode_json_game_state(json_str);
+        }
+
+        static data_types::game_state decode_json_game_state(const std::string_view json_str)
+        {
+            auto game_state = data_types::game_state{};
+            from_json_sax(json_str, game_state, current_version);
+            return game_state;
+        }
+
+        static std::string get_stage_state_key(const data_types::stage stage)
+        {
+            return "stage_state_" + std::to_string(static_cast<int>(stage));
+        }
+
+        static std::string get_journal_key(const data_types::stage stage)
+        {
+            return "stage_journal_" + std::to_string(static_cast<int>(stage));
+        }
+
+        /*
+        Write the state of the given stage, and reset the journal of the stage
+        (if the backend has one).
+        With a journal, the snapshot is encoded right away, since the journal
+        refers to it. Otherwise, it's encoded when written, so that
+        consecutive snapshots of a stage are only encoded once.
+        */
+        void write_snapshot(const data_types::stage stage)
+        {
+            //Without a native append, appending a move would read the whole
+            //journal and write it back, which costs more than a snapshot.
+            //A journal left over from another backend doesn't apply to the
+            //new snapshot, and is therefore ignored at load time.
+            if(backend_.has_native_append())
             {
-                //Convert to JSON
-                const auto json = nlohmann::json(*opt_game_state_);
+                const auto psnapshot = std::make_shared<const persistence_queue::buffer_t>(encode_stage_state(stage));
 
-                //Get JSON string
-                auto oss = std::ostringstream{};
-                oss << json;
+                write_queue_.push
+                (
+                    get_stage_state_key(stage),
+                    [psnapshot]
+                    {
+                        return *psnapshot;
+                    }
+                );
 
-                auto pstr = std::make_shared<std::string>(oss.str());
+                write_queue_.push
+                (
+                    get_journal_key(stage),
+                    [journal_header = make_journal_header(*psnapshot)]
+                    {
+                        return journal_header;
+                    }
+                );
 
-                indexed_db::async_write_v2
+                journal_lengths_[stage] = 0;
+            }
+            else
+            {
+                write_queue_.push
                 (
-                    "ternarii",
-                    "game_state",
-                    pstr->data(),
-                    pstr->size(),
-                    [pstr]
-                    {
-                        libutil::log::info("Write success.");
-                    },
-                    [this]()
-                    {
-                        libutil::log::error("Write error");
-                        if(fail_on_access_error_)
-                            throw std::runtime_error{"Write error"};
+                    get_stage_state_key(stage),
+                    [this, stage]
+                    {
+                        return encode_stage_state(stage);
                     }
                 );
             }
-            catch(const std::exception& e)
+
+            update_summary(stage);
+        }
+
+        //Keep the hi-score of the index in sync with the state of the stage
+        void update_summary(const data_types::stage stage)
+        {
+            const auto hi_score = stage_states_.at(stage).hi_score;
+            const auto [summary_it, inserted] = index_.summaries.try_emplace(stage, data_types::stage_summary{hi_score});
+            if(inserted || summary_it->second.hi_score != hi_score)
+            {
+                summary_it->second.hi_score = hi_score;
+                write_index();
+            }
+        }
+
+        void set_last_played_stage(const data_types::stage stage)
+        {
+            if(index_.opt_last_played_stage != stage)
             {
-                std::cerr << e.what() << '\n';
-                if(fail_on_access_error_)
-                    throw;
+                index_.opt_last_played_stage = stage;
+                write_index();
             }
-            catch(...)
+        }
+
+        void write_index()
+        {
+            write_queue_.push
+            (
+                "stage_index",
+                [this]
+                {
+                    return to_binary(index_);
+                }
+            );
+        }
+
+        //Encode the state of the given stage only, as a single-stage game state
+        persistence_queue::buffer_t encode_stage_state(const data_types::stage stage) const
+        {
+            auto state = data_types::game_state{};
+            state.stage_states[stage] = stage_states_.at(stage);
+
+            if(auto opt_data = to_binary(state))
             {
-                std::cerr << "Unknown error\n";
-                if(fail_on_access_error_)
-                    throw;
+                return std::move(*opt_data);
             }
+
+            //Some tile values don't fit in the binary format
+            libutil::log::info("Falling back to JSON format");
+            const auto json_str = nlohmann::json(state).dump();
+            const auto pdata = reinterpret_cast<const std::byte*>(json_str.data());
+            return persistence_queue::buffer_t(pdata, pdata + json_str.size());
         }
 
     private:
         const bool fail_on_access_error_;
         event_handler event_handler_;
-        std::optional<data_types::game_state> opt_game_state_;
+        metering_storage_backend backend_;
+        persistence_queue write_queue_;
+        game_history game_history_;
+
+        stage_index index_;
+
+        //Stages whose state is known (whether they have one or not)
+        std::set<data_types::stage> loaded_stages_;
+
+        data_types::stage_state_map stage_states_;
+        std::map<data_types::stage, std::vector<stage_state_callback>> pending_loads_;
+        int pending_read_count_ = 0;
+
+        //Number of moves in the journal of each stage (absent if the journal
+        //doesn't apply to the stored snapshot)
+        std::map<data_types::stage, int> journal_lengths_;
 };
 
 database::database
@@ -192,15 +761,75 @@ database::database
     const bool fail_on_access_error,
     const event_handler& evt_handler
 ):
-    pimpl_(std::make_unique<impl>(fail_on_access_error, evt_handler))
+    database(fail_on_access_error, evt_handler, make_default_storage_backend())
+{
+}
+
+database::database
+(
+    const bool fail_on_access_error,
+    const event_handler& evt_handler,
+    std::unique_ptr<storage_backend>&& pbackend
+):
+    pimpl_(std::make_unique<impl>(fail_on_access_error, evt_handler, std::move(pbackend)))
 {
 }
 
 database::~database() = default;
 
-const std::optional<data_types::game_state>& database::get_game_state() const
+void database::add_move
+(
+    const data_types::stage stage,
+    const libgame::data_types::input_layout& layout,
+    const data_types::stage_state& state
+)
+{
+    pimpl_->add_move(stage, layout, state);
+}
+
+void database::add_finished_game(const data_types::stage stage, const data_types::game_record& record)
+{
+    pimpl_->add_finished_game(stage, record);
+}
+
+void database::async_get_game_ranking(const data_types::stage stage, const game_ranking_callback& callback)
+{
+    pimpl_->async_get_game_ranking(stage, callback);
+}
+
+void database::advance()
+{
+    pimpl_->advance();
+}
+
+void database::flush()
+{
+    pimpl_->flush();
+}
+
+const data_types::stage_summary_map& database::get_stage_summaries() const
+{
+    return pimpl_->get_stage_summaries();
+}
+
+std::optional<data_types::stage> database::get_last_played_stage() const
+{
+    return pimpl_->get_last_played_stage();
+}
+
+void database::prefetch_stage_state(const data_types::stage stage)
+{
+    pimpl_->prefetch_stage_state(stage);
+}
+
+void database::async_get_stage_state(const data_types::stage stage, const stage_state_callback& callback)
+{
+    pimpl_->async_get_stage_state(stage, callback);
+}
+
+const data_types::stage_state* database::find_stage_state(const data_types::stage stage) const
 {
-    return pimpl_->get_game_state();
+    return pimpl_->find_stage_state(stage);
 }
 
 void database::set_stage_state(const data_types::stage stage, const data_types::stage_state& state)
@@ -0,0 +1,55 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <libdb/events.hpp>
+
+namespace libdb::events
+{
+
+std::ostream& operator<<(std::ostream& l, const read_metrics& r)
+{
+    l << "read_metrics";
+    l << "{";
+    l << "key: " << r.key << ", ";
+    l << "byte_count: " << r.byte_count << ", ";
+    l << "read_duration: " << r.read_duration.count() << "us, ";
+    l << "parse_duration: " << r.parse_duration.count() << "us, ";
+    l << "overlapping_transaction_count: " << r.overlapping_transaction_count << ", ";
+    l << "success: " << r.success;
+    l << "}";
+    return l;
+}
+
+std::ostream& operator<<(std::ostream& l, const write_metrics& r)
+{
+    l << "write_metrics";
+    l << "{";
+    l << "key: " << r.key << ", ";
+    l << "byte_count: " << r.byte_count << ", ";
+    l << "append: " << r.append << ", ";
+    l << "encode_duration: " << r.encode_duration.count() << "us, ";
+    l << "request_to_completion_duration: " << r.request_to_completion_duration.count() << "us, ";
+    l << "write_duration: " << r.write_duration.count() << "us, ";
+    l << "overlapping_transaction_count: " << r.overlapping_transaction_count << ", ";
+    l << "success: " << r.success;
+    l << "}";
+    return l;
+}
+
+} //namespace
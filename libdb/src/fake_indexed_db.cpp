@@ -0,0 +1,297 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "indexed_db.hpp"
+#include <libdb/fake_indexed_db.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace libdb::fake_indexed_db
+{
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+    using buffer_t = std::vector<std::byte>;
+
+    //database name, store name, key (-1 for v2 entries)
+    using entry_id = std::tuple<std::string, std::string, int>;
+
+    struct transaction
+    {
+        clock::time_point completion_time;
+
+        //Called on completion, with true on success
+        std::function<void(bool)> complete;
+    };
+
+    struct context
+    {
+        configuration conf;
+        statistics stats;
+        std::mt19937 rng;
+        std::map<entry_id, buffer_t> entries;
+        std::deque<transaction> transactions;
+    };
+
+    context& get_context()
+    {
+        static auto ctx = context{};
+        return ctx;
+    }
+
+    //Transactions are serialized, as on a single connection
+    void push_transaction(const std::size_t size, std::function<void(bool)>&& complete)
+    {
+        auto& ctx = get_context();
+
+        auto start_time = clock::now();
+        if(!ctx.transactions.empty())
+        {
+            start_time = std::max(start_time, ctx.transactions.back().completion_time);
+        }
+
+        auto duration = std::chrono::duration_cast<clock::duration>(ctx.conf.latency);
+        if(ctx.conf.throughput > 0)
+        {
+            duration += std::chrono::duration_cast<clock::duration>
+            (
+                std::chrono::duration<double>{static_cast<double>(size) / ctx.conf.throughput}
+            );
+        }
+
+        ctx.transactions.push_back(transaction{start_time + duration, std::move(complete)});
+    }
+
+    bool draw_failure()
+    {
+        auto& ctx = get_context();
+        if(ctx.conf.failure_probability <= 0)
+        {
+            return false;
+        }
+        return std::bernoulli_distribution{ctx.conf.failure_probability}(ctx.rng);
+    }
+
+    void complete_front_transaction()
+    {
+        auto& ctx = get_context();
+        auto tr = std::move(ctx.transactions.front());
+        ctx.transactions.pop_front();
+
+        const auto success = !draw_failure();
+        if(!success)
+        {
+            ++ctx.stats.failure_count;
+        }
+        tr.complete(success);
+    }
+
+    void async_read_entry
+    (
+        const entry_id& id,
+        const indexed_db::read_success_callback_t& success_callback,
+        const std::function<void()>& failure_callback
+    )
+    {
+        auto& ctx = get_context();
+        ++ctx.stats.read_count;
+
+        const auto it = ctx.entries.find(id);
+        const auto size = it != ctx.entries.end() ? it->second.size() : std::size_t{0};
+
+        push_transaction
+        (
+            size,
+            [id, success_callback, failure_callback](const bool success)
+            {
+                if(!success)
+                {
+                    failure_callback();
+                    return;
+                }
+
+                //Read the entry as it is when the transaction completes
+                auto& ctx = get_context();
+                const auto it = ctx.entries.find(id);
+                if(it == ctx.entries.end())
+                {
+                    success_callback(nullptr, 0);
+                    return;
+                }
+
+                //The callback may modify the entry
+                auto data = it->second;
+                ctx.stats.read_byte_count += data.size();
+                success_callback(data.data(), static_cast<int>(data.size()));
+            }
+        );
+    }
+}
+
+void configure(const configuration& conf)
+{
+    auto& ctx = get_context();
+    ctx.conf = conf;
+    ctx.rng.seed(conf.seed);
+}
+
+const statistics& get_statistics()
+{
+    return get_context().stats;
+}
+
+void reset_statistics()
+{
+    get_context().stats = statistics{};
+}
+
+void reset()
+{
+    auto& ctx = get_context();
+    ctx.stats = statistics{};
+    ctx.entries.clear();
+    ctx.transactions.clear();
+}
+
+int get_pending_transaction_count()
+{
+    return static_cast<int>(get_context().transactions.size());
+}
+
+void poll()
+{
+    auto& ctx = get_context();
+
+    //Don't complete the transactions issued by the callbacks
+    auto count = ctx.transactions.size();
+
+    const auto now = clock::now();
+    while(count != 0 && !ctx.transactions.empty() && ctx.transactions.front().completion_time <= now)
+    {
+        complete_front_transaction();
+        --count;
+    }
+}
+
+bool wait()
+{
+    auto& ctx = get_context();
+
+    if(ctx.transactions.empty())
+    {
+        return false;
+    }
+
+    std::this_thread::sleep_until(ctx.transactions.front().completion_time);
+    complete_front_transaction();
+    return true;
+}
+
+} //namespace
+
+namespace libdb::indexed_db
+{
+
+void async_read
+(
+    const char* database_name,
+    const char* store_name,
+    const int key,
+    const indexed_db::read_success_callback_t& success_callback,
+    const failure_callback_t& failure_callback
+)
+{
+    fake_indexed_db::async_read_entry
+    (
+        {database_name, store_name, key},
+        success_callback,
+        [failure_callback]
+        {
+            failure_callback("Injected failure");
+        }
+    );
+}
+
+void async_read_v2
+(
+    const char* database_name,
+    const char* store_name,
+    const indexed_db::read_success_callback_t& success_callback,
+    const failure_callback_2_t& failure_callback
+)
+{
+    fake_indexed_db::async_read_entry
+    (
+        {database_name, store_name, -1},
+        success_callback,
+        failure_callback
+    );
+}
+
+void async_write_v2
+(
+    const char* database_name,
+    const char* store_name,
+    void* data,
+    const int size,
+    const write_success_callback_t& success_callback,
+    const failure_callback_2_t& failure_callback
+)
+{
+    auto& ctx = fake_indexed_db::get_context();
+    ++ctx.stats.write_count;
+
+    //Like emscripten_idb_async_store(), copy the data right away
+    const auto pdata = static_cast<const std::byte*>(data);
+    auto buffer = fake_indexed_db::buffer_t(pdata, pdata + size);
+
+    fake_indexed_db::push_transaction
+    (
+        buffer.size(),
+        [
+            id = fake_indexed_db::entry_id{database_name, store_name, -1},
+            buffer = std::move(buffer),
+            success_callback,
+            failure_callback
+        ](const bool success) mutable
+        {
+            if(!success)
+            {
+                failure_callback();
+                return;
+            }
+
+            auto& ctx = fake_indexed_db::get_context();
+            ctx.stats.written_byte_count += buffer.size();
+            ctx.entries[id] = std::move(buffer);
+            success_callback();
+        }
+    );
+}
+
+} //namespace
@@ -0,0 +1,497 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <libdb/storage_backend.hpp>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace libdb
+{
+
+namespace
+{
+    std::string make_error_string(const char* what, const std::filesystem::path& path)
+    {
+        return std::string{what} + " " + path.string() + ": " + std::strerror(errno);
+    }
+
+    //Closes the file descriptor on destruction
+    struct file_descriptor
+    {
+        ~file_descriptor()
+        {
+            if(fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+
+        int fd = -1;
+    };
+
+    //Write the whole buffer, retrying on partial writes
+    bool write_all(const int fd, const void* data, const std::size_t size)
+    {
+        auto pdata = static_cast<const char*>(data);
+        auto remaining_size = size;
+        while(remaining_size != 0)
+        {
+            const auto written_size = ::write(fd, pdata, remaining_size);
+            if(written_size < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            pdata += written_size;
+            remaining_size -= static_cast<std::size_t>(written_size);
+        }
+        return true;
+    }
+
+    //Unmaps the memory on destruction
+    struct memory_mapping
+    {
+        memory_mapping() = default;
+
+        memory_mapping(const memory_mapping&) = delete;
+
+        ~memory_mapping()
+        {
+            if(ptr != MAP_FAILED)
+            {
+                ::munmap(ptr, size);
+            }
+        }
+
+        void* ptr = MAP_FAILED;
+        std::size_t size = 0;
+    };
+
+    /*
+    The data is read with mmap().
+    The data is written into a temporary file, which then replaces the entry
+    file with rename(), so that an interrupted write never leaves a
+    truncated entry behind.
+    Appends are done in place (an interrupted append may leave a truncated
+    record at the end of the entry).
+    Operations are executed by a worker thread, in the order they were
+    requested, so that disk accesses never block the caller. Their callbacks
+    are called by poll().
+    */
+    class file_storage_backend: public storage_backend
+    {
+        private:
+            //Called by poll(), in the caller thread
+            using completion_t = std::function<void()>;
+
+            //Called in the worker thread
+            using operation_t = std::function<completion_t()>;
+
+        public:
+            file_storage_backend(const std::filesystem::path& root_dir):
+                root_dir_(root_dir),
+                worker_thread_([this]{run_operations_until_stopped();})
+            {
+            }
+
+            ~file_storage_backend()
+            {
+                //Let the worker complete the pending operations, so that no
+                //write is lost
+                {
+                    auto lock = std::lock_guard{mutex_};
+                    stopping_ = true;
+                }
+                operation_condition_.notify_one();
+                worker_thread_.join();
+            }
+
+            void async_read
+            (
+                const char* database_name,
+                const char* store_name,
+                const read_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            ) override
+            {
+                push_operation
+                (
+                    [
+                        path = get_path(database_name, store_name),
+                        success_callback,
+                        failure_callback
+                    ]
+                    {
+                        return read(path, success_callback, failure_callback);
+                    }
+                );
+            }
+
+            void async_write
+            (
+                const char* database_name,
+                const char* store_name,
+                const void* data,
+                const int size,
+                const write_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            ) override
+            {
+                push_operation
+                (
+                    [
+                        path = get_path(database_name, store_name),
+                        data,
+                        size,
+                        success_callback,
+                        failure_callback
+                    ]
+                    {
+                        return write(path, data, size, success_callback, failure_callback);
+                    }
+                );
+            }
+
+            void async_append
+            (
+                const char* database_name,
+                const char* store_name,
+                const void* data,
+                const int size,
+                const write_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            ) override
+            {
+                push_operation
+                (
+                    [
+                        path = get_path(database_name, store_name),
+                        data,
+                        size,
+                        success_callback,
+                        failure_callback
+                    ]
+                    {
+                        return append(path, data, size, success_callback, failure_callback);
+                    }
+                );
+            }
+
+            bool has_native_append() const override
+            {
+                return true;
+            }
+
+            void poll() override
+            {
+                auto completions = std::vector<completion_t>{};
+                {
+                    auto lock = std::lock_guard{mutex_};
+                    completions.swap(completions_);
+                }
+
+                //Operations requested by the callbacks are counted right away
+                pending_operation_count_ -= static_cast<int>(completions.size());
+
+                for(auto& completion: completions)
+                {
+                    completion();
+                }
+            }
+
+            bool wait() override
+            {
+                if(pending_operation_count_ == 0)
+                {
+                    return false;
+                }
+
+                {
+                    auto lock = std::unique_lock{mutex_};
+                    completion_condition_.wait
+                    (
+                        lock,
+                        [this]
+                        {
+                            return !completions_.empty();
+                        }
+                    );
+                }
+
+                poll();
+                return true;
+            }
+
+        private:
+            std::filesystem::path get_path(const char* database_name, const char* store_name) const
+            {
+                return root_dir_ / database_name / store_name;
+            }
+
+            void push_operation(operation_t&& operation)
+            {
+                {
+                    auto lock = std::lock_guard{mutex_};
+                    operations_.push_back(std::move(operation));
+                }
+                operation_condition_.notify_one();
+
+                ++pending_operation_count_;
+            }
+
+            void run_operations_until_stopped()
+            {
+                while(true)
+                {
+                    auto operation = operation_t{};
+
+                    {
+                        auto lock = std::unique_lock{mutex_};
+                        operation_condition_.wait
+                        (
+                            lock,
+                            [this]
+                            {
+                                return stopping_ || !operations_.empty();
+                            }
+                        );
+
+                        if(operations_.empty())
+                        {
+                            return;
+                        }
+
+                        operation = std::move(operations_.front());
+                        operations_.pop_front();
+                    }
+
+                    auto completion = operation();
+
+                    {
+                        auto lock = std::lock_guard{mutex_};
+                        completions_.push_back(std::move(completion));
+                    }
+                    completion_condition_.notify_one();
+                }
+            }
+
+            static completion_t make_failure_completion(const failure_callback_t& failure_callback, std::string&& error)
+            {
+                return [failure_callback, error = std::move(error)]
+                {
+                    failure_callback(error.c_str());
+                };
+            }
+
+            static completion_t read
+            (
+                const std::filesystem::path& path,
+                const read_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            )
+            {
+                auto file = file_descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+                if(file.fd < 0)
+                {
+                    if(errno == ENOENT)
+                    {
+                        return [success_callback]
+                        {
+                            success_callback(nullptr, 0);
+                        };
+                    }
+                    return make_failure_completion(failure_callback, make_error_string("Can't open", path));
+                }
+
+                struct stat file_status;
+                if(::fstat(file.fd, &file_status) != 0)
+                {
+                    return make_failure_completion(failure_callback, make_error_string("Can't stat", path));
+                }
+
+                if(file_status.st_size == 0)
+                {
+                    return [success_callback]
+                    {
+                        success_callback(nullptr, 0);
+                    };
+                }
+
+                //Kept alive until the completion is destroyed
+                auto pmapping = std::make_shared<memory_mapping>();
+                pmapping->size = static_cast<std::size_t>(file_status.st_size);
+                pmapping->ptr = ::mmap(nullptr, pmapping->size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+                if(pmapping->ptr == MAP_FAILED)
+                {
+                    return make_failure_completion(failure_callback, make_error_string("Can't map", path));
+                }
+
+                return [success_callback, pmapping]
+                {
+                    success_callback(pmapping->ptr, static_cast<int>(pmapping->size));
+                };
+            }
+
+            static completion_t write
+            (
+                const std::filesystem::path& path,
+                const void* data,
+                const int size,
+                const write_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            )
+            {
+                const auto dir_path = path.parent_path();
+                auto tmp_path = path;
+                tmp_path += ".tmp";
+
+                {
+                    auto ec = std::error_code{};
+                    std::filesystem::create_directories(dir_path, ec);
+                    if(ec)
+                    {
+                        return make_failure_completion(failure_callback, "Can't create " + dir_path.string() + ": " + ec.message());
+                    }
+                }
+
+                //Don't leave the temporary file behind
+                const auto fail = [&](const char* what, const std::filesystem::path& failure_path)
+                {
+                    auto error = make_error_string(what, failure_path);
+                    ::unlink(tmp_path.c_str());
+                    return make_failure_completion(failure_callback, std::move(error));
+                };
+
+                //Write temporary file
+                {
+                    auto file = file_descriptor
+                    {
+                        ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+                    };
+                    if(file.fd < 0)
+                    {
+                        return fail("Can't open", tmp_path);
+                    }
+
+                    if(!write_all(file.fd, data, static_cast<std::size_t>(size)))
+                    {
+                        return fail("Can't write", tmp_path);
+                    }
+
+                    if(::fsync(file.fd) != 0)
+                    {
+                        return fail("Can't sync", tmp_path);
+                    }
+                }
+
+                //Replace entry file
+                if(::rename(tmp_path.c_str(), path.c_str()) != 0)
+                {
+                    return fail("Can't rename", tmp_path);
+                }
+
+                //Persist the rename
+                {
+                    auto dir = file_descriptor{::open(dir_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+                    if(dir.fd >= 0)
+                    {
+                        ::fsync(dir.fd);
+                    }
+                }
+
+                return success_callback;
+            }
+
+            static completion_t append
+            (
+                const std::filesystem::path& path,
+                const void* data,
+                const int size,
+                const write_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            )
+            {
+                {
+                    auto ec = std::error_code{};
+                    std::filesystem::create_directories(path.parent_path(), ec);
+                    if(ec)
+                    {
+                        return make_failure_completion(failure_callback, "Can't create " + path.parent_path().string() + ": " + ec.message());
+                    }
+                }
+
+                auto file = file_descriptor
+                {
+                    ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)
+                };
+                if(file.fd < 0)
+                {
+                    return make_failure_completion(failure_callback, make_error_string("Can't open", path));
+                }
+
+                if(!write_all(file.fd, data, static_cast<std::size_t>(size)))
+                {
+                    return make_failure_completion(failure_callback, make_error_string("Can't write", path));
+                }
+
+                if(::fdatasync(file.fd) != 0)
+                {
+                    return make_failure_completion(failure_callback, make_error_string("Can't sync", path));
+                }
+
+                return success_callback;
+            }
+
+        private:
+            std::filesystem::path root_dir_;
+
+            //Only accessed by the caller thread
+            int pending_operation_count_ = 0;
+
+            std::mutex mutex_;
+            std::condition_variable operation_condition_;
+            std::condition_variable completion_condition_;
+            std::deque<operation_t> operations_; //guarded by mutex_
+            std::vector<completion_t> completions_; //guarded by mutex_
+            bool stopping_ = false; //guarded by mutex_
+
+            //Last, so that it's started once everything else is initialized
+            std::thread worker_thread_;
+    };
+}
+
+std::unique_ptr<storage_backend> make_file_storage_backend(const std::filesystem::path& root_dir)
+{
+    return std::make_unique<file_storage_backend>(root_dir);
+}
+
+} //namespace
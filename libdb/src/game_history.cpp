@@ -0,0 +1,402 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "game_history.hpp"
+#include "binary_conversion.hpp"
+#include <libutil/log.hpp>
+#include <algorithm>
+#include <span>
+
+namespace libdb
+{
+
+namespace
+{
+    void add_to_ranking(data_types::game_ranking& ranking, const data_types::game_record& record)
+    {
+        //Update the aggregates
+        auto& stats = ranking.stats;
+        ++stats.game_count;
+        stats.best_score = std::max(stats.best_score, record.score);
+        stats.best_tile_value = std::max(stats.best_tile_value, record.max_tile_value);
+        stats.total_score += record.score;
+        stats.total_move_count += record.move_count;
+        stats.total_time_s += record.time_s;
+
+        //Update the best games
+        auto& games = ranking.best_games;
+        const auto it = std::upper_bound
+        (
+            games.begin(),
+            games.end(),
+            record.score,
+            [](const int score, const data_types::game_record& game)
+            {
+                return score > game.score;
+            }
+        );
+
+        if(it != games.end() || games.size() < game_history::best_game_count)
+        {
+            games.insert(it, record);
+            if(games.size() > game_history::best_game_count)
+            {
+                games.pop_back();
+            }
+        }
+    }
+
+    std::span<const std::byte> make_span(const void* data, const int size)
+    {
+        return std::span
+        {
+            static_cast<const std::byte*>(data),
+            static_cast<std::size_t>(data ? size : 0)
+        };
+    }
+}
+
+game_history::game_history
+(
+    storage_backend& backend,
+    persistence_queue& write_queue,
+    const char* database_name
+):
+    backend_(backend),
+    write_queue_(write_queue),
+    database_name_(database_name)
+{
+}
+
+void game_history::add_game(const data_types::stage stage, const data_types::game_record& record)
+{
+    if(histories_.contains(stage))
+    {
+        insert(stage, record);
+        return;
+    }
+
+    //We need the game count and the last segment of the stage to know where
+    //to append
+    pending_games_[stage].push_back(record);
+    async_load(stage);
+}
+
+void game_history::async_get_ranking(const data_types::stage stage, const ranking_callback& callback)
+{
+    if(const auto it = histories_.find(stage); it != histories_.end())
+    {
+        callback(it->second.ranking);
+        return;
+    }
+
+    pending_loads_[stage].push_back(callback);
+    async_load(stage);
+}
+
+void game_history::on_write_failure()
+{
+    for(auto& [stage, history]: histories_)
+    {
+        history.appendable = false;
+    }
+}
+
+bool game_history::is_loading() const
+{
+    return !loading_stages_.empty();
+}
+
+void game_history::async_load(const data_types::stage stage)
+{
+    //Load already in progress
+    if(!loading_stages_.insert(stage).second)
+    {
+        return;
+    }
+
+    backend_.async_read
+    (
+        database_name_.c_str(),
+        get_ranking_key(stage).c_str(),
+        [this, stage](const void* data, int size)
+        {
+            auto opt_ranking = game_ranking_from_binary(make_span(data, size));
+
+            if(!opt_ranking)
+            {
+                if(data && size != 0)
+                {
+                    libutil::log::error("Invalid game ranking for stage ", static_cast<int>(stage), ", rebuilding it");
+                }
+
+                async_rebuild_ranking(stage, std::make_shared<data_types::game_ranking>(), 0);
+                return;
+            }
+
+            //Check that the last segment agrees with the ranking
+            const auto game_count = opt_ranking->stats.game_count;
+            const auto last_segment = game_count / segment_size;
+            async_read_segment
+            (
+                stage,
+                last_segment,
+                [this, stage, last_segment, game_count, ranking = std::move(*opt_ranking)](game_list&& games, const bool intact) mutable
+                {
+                    if(static_cast<int>(games.size()) != game_count % segment_size)
+                    {
+                        libutil::log::error("Game ranking of stage ", static_cast<int>(stage), " doesn't match the game history, rebuilding it");
+                        async_rebuild_ranking(stage, std::make_shared<data_types::game_ranking>(), 0);
+                        return;
+                    }
+
+                    on_loaded(stage, std::move(ranking), last_segment, games, intact);
+                }
+            );
+        },
+        [this, stage](const char* error)
+        {
+            on_load_failure(stage, error);
+        }
+    );
+}
+
+void game_history::async_read_segment
+(
+    const data_types::stage stage,
+    const int segment,
+    const segment_callback& callback
+)
+{
+    backend_.async_read
+    (
+        database_name_.c_str(),
+        get_segment_key(stage, segment).c_str(),
+        [this, stage, segment, callback](const void* data, int size)
+        {
+            if(!data || size == 0)
+            {
+                callback({}, true);
+                return;
+            }
+
+            //Don't risk overwriting a segment we can't read
+            auto opt_segment = game_history_from_binary(make_span(data, size));
+            if(!opt_segment)
+            {
+                on_load_failure(stage, "Invalid game history segment");
+                return;
+            }
+
+            //Drop the records that aren't where they should be
+            auto& games = opt_segment->games;
+            const auto first_index = segment * segment_size;
+            for(auto i = std::size_t{0}; i < games.size(); ++i)
+            {
+                if(games[i].index != first_index + static_cast<int>(i))
+                {
+                    games.resize(i);
+                    opt_segment->intact = false;
+                    break;
+                }
+            }
+
+            callback(std::move(games), opt_segment->intact);
+        },
+        [this, stage](const char* error)
+        {
+            on_load_failure(stage, error);
+        }
+    );
+}
+
+void game_history::async_rebuild_ranking
+(
+    const data_types::stage stage,
+    const std::shared_ptr<data_types::game_ranking>& pranking,
+    const int segment
+)
+{
+    async_read_segment
+    (
+        stage,
+        segment,
+        [this, stage, pranking, segment](game_list&& games, const bool intact)
+        {
+            for(const auto& game: games)
+            {
+                add_to_ranking(*pranking, game);
+            }
+
+            if(static_cast<int>(games.size()) == segment_size)
+            {
+                async_rebuild_ranking(stage, pranking, segment + 1);
+                return;
+            }
+
+            libutil::log::info("Rebuilt game ranking of stage ", static_cast<int>(stage), " from ", pranking->stats.game_count, " game(s)");
+
+            on_loaded(stage, std::move(*pranking), segment, games, intact);
+            write_ranking(stage);
+        }
+    );
+}
+
+void game_history::on_loaded
+(
+    const data_types::stage stage,
+    data_types::game_ranking&& ranking,
+    const int last_segment,
+    const game_list& last_segment_games,
+    const bool last_segment_intact
+)
+{
+    auto& history = histories_[stage];
+    history.ranking = std::move(ranking);
+
+    //Re-encode the records, so that a truncated record left by an
+    //interrupted write is dropped at the next write (which therefore must
+    //rewrite the whole segment)
+    history.appendable = last_segment_intact;
+    history.last_segment.clear();
+    if(!last_segment_games.empty())
+    {
+        history.last_segment = make_game_history_header(last_segment * segment_size);
+        for(const auto& game: last_segment_games)
+        {
+            const auto record_data = to_binary(game);
+            history.last_segment.insert(history.last_segment.end(), record_data.begin(), record_data.end());
+        }
+    }
+
+    loading_stages_.erase(stage);
+
+    if(const auto it = pending_games_.find(stage); it != pending_games_.end())
+    {
+        const auto games = std::move(it->second);
+        pending_games_.erase(it);
+
+        for(const auto& game: games)
+        {
+            insert(stage, game);
+        }
+    }
+
+    if(const auto it = pending_loads_.find(stage); it != pending_loads_.end())
+    {
+        const auto callbacks = std::move(it->second);
+        pending_loads_.erase(it);
+
+        for(const auto& callback: callbacks)
+        {
+            callback(history.ranking);
+        }
+    }
+}
+
+void game_history::on_load_failure(const data_types::stage stage, const char* error)
+{
+    libutil::log::error("Can't load game history of stage ", static_cast<int>(stage), ": ", error);
+
+    //Don't cache anything, so that the next call retries
+    loading_stages_.erase(stage);
+
+    if(const auto it = pending_loads_.find(stage); it != pending_loads_.end())
+    {
+        const auto callbacks = std::move(it->second);
+        pending_loads_.erase(it);
+
+        for(const auto& callback: callbacks)
+        {
+            callback(data_types::game_ranking{});
+        }
+    }
+}
+
+void game_history::insert(const data_types::stage stage, data_types::game_record record)
+{
+    auto& history = histories_.at(stage);
+
+    record.index = history.ranking.stats.game_count;
+    add_to_ranking(history.ranking, record);
+
+    //Append the game to the history.
+    //A new segment is only started once the last one is full, and the last
+    //one has been read at load time, so the new one doesn't exist yet.
+    {
+        auto& data = history.last_segment;
+
+        const auto new_segment = record.index % segment_size == 0;
+        if(new_segment)
+        {
+            data = make_game_history_header(record.index);
+        }
+
+        const auto record_data = to_binary(record);
+        data.insert(data.end(), record_data.begin(), record_data.end());
+
+        const auto key = get_segment_key(stage, record.index / segment_size);
+        if(!new_segment && history.appendable && backend_.has_native_append())
+        {
+            write_queue_.push_append(key, record_data);
+        }
+        else
+        {
+            //Without a native append, appending would read the whole segment
+            //and write it back anyway
+            write_queue_.push
+            (
+                key,
+                [pdata = std::make_shared<const persistence_queue::buffer_t>(data)]
+                {
+                    return *pdata;
+                }
+            );
+            history.appendable = true;
+        }
+    }
+
+    //Written after the history, so that the ranking never refers to games
+    //that aren't stored
+    write_ranking(stage);
+}
+
+void game_history::write_ranking(const data_types::stage stage)
+{
+    write_queue_.push
+    (
+        get_ranking_key(stage),
+        [this, stage]
+        {
+            return to_binary(histories_.at(stage).ranking);
+        }
+    );
+}
+
+std::string game_history::get_ranking_key(const data_types::stage stage)
+{
+    return "game_ranking_" + std::to_string(static_cast<int>(stage));
+}
+
+std::string game_history::get_segment_key(const data_types::stage stage, const int segment)
+{
+    return "game_history_" + std::to_string(static_cast<int>(stage)) + "_" + std::to_string(segment);
+}
+
+} //namespace
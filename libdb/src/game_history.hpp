@@ -0,0 +1,154 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDB_GAME_HISTORY_HPP
+#define LIBDB_GAME_HISTORY_HPP
+
+#include "persistence_queue.hpp"
+#include <libdb/data_types.hpp>
+#include <libdb/storage_backend.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace libdb
+{
+
+/*
+History of the finished games of each stage.
+
+Games are appended to the history of their stage, which is split into
+segments of segment_size games, under the "game_history_<stage>_<segment>"
+keys. On backends that can append natively, a new game is appended to the
+last segment of its stage. Otherwise (or if the stored segment ends with a
+torn record), the last segment, which is kept in memory, is written as a
+whole, so that adding a game never requires reading the segment back. Full
+segments are never rewritten.
+
+The ranking of each stage (aggregates and best_game_count best games) is
+kept up to date on insert and stored under the "game_ranking_<stage>" key,
+so that it can be read without loading the whole history. Inserting a game
+costs a binary search among the best games.
+
+Loading the ranking of a stage also loads the last segment, to check that
+both agree. If they don't, or if the ranking is missing or invalid, the
+ranking is rebuilt from the segments.
+If a read fails, nothing is cached: the ranking callbacks get an empty
+ranking, and the games to insert stay pending until the next (successful)
+load, which is attempted on the next call to add_game() or
+async_get_ranking().
+*/
+class game_history
+{
+    public:
+        static constexpr auto best_game_count = 100;
+        static constexpr auto segment_size = 1024;
+
+        using ranking_callback = std::function<void(const data_types::game_ranking&)>;
+
+        game_history
+        (
+            storage_backend& backend,
+            persistence_queue& write_queue,
+            const char* database_name
+        );
+
+        //Set the index of the given game, and append it to the history
+        void add_game(data_types::stage stage, const data_types::game_record& record);
+
+        /*
+        Load the ranking of the given stage, if needed, and give it to the
+        callback.
+        Note: If the ranking is already loaded, the callback is called right
+        away.
+        */
+        void async_get_ranking(data_types::stage stage, const ranking_callback& callback);
+
+        //Call when a write fails, as stored segments may not be what we think
+        void on_write_failure();
+
+        //Whether a ranking is being loaded
+        bool is_loading() const;
+
+    private:
+        using game_list = std::vector<data_types::game_record>;
+        //Intact: whether the stored segment holds exactly the given games
+        using segment_callback = std::function<void(game_list&& games, bool intact)>;
+
+        struct stage_history
+        {
+            data_types::game_ranking ranking;
+
+            //Header and records of the segment the next game goes to (empty
+            //if the segment doesn't exist yet)
+            persistence_queue::buffer_t last_segment;
+
+            //Whether the stored last segment is last_segment, so that new
+            //games can be appended to it (if the backend can append natively)
+            bool appendable = false;
+        };
+
+        void async_load(data_types::stage stage);
+
+        //Read the games of the given segment (none if it doesn't exist)
+        void async_read_segment(data_types::stage stage, int segment, const segment_callback& callback);
+
+        void async_rebuild_ranking
+        (
+            data_types::stage stage,
+            const std::shared_ptr<data_types::game_ranking>& pranking,
+            int segment
+        );
+
+        void on_loaded
+        (
+            data_types::stage stage,
+            data_types::game_ranking&& ranking,
+            int last_segment,
+            const game_list& last_segment_games,
+            bool last_segment_intact
+        );
+
+        void on_load_failure(data_types::stage stage, const char* error);
+
+        void insert(data_types::stage stage, data_types::game_record record);
+
+        void write_ranking(data_types::stage stage);
+
+        static std::string get_ranking_key(data_types::stage stage);
+
+        static std::string get_segment_key(data_types::stage stage, int segment);
+
+    private:
+        storage_backend& backend_;
+        persistence_queue& write_queue_;
+        const std::string database_name_;
+
+        std::map<data_types::stage, stage_history> histories_;
+        std::map<data_types::stage, std::vector<ranking_callback>> pending_loads_;
+        std::map<data_types::stage, game_list> pending_games_;
+        std::set<data_types::stage> loading_stages_;
+};
+
+} //namespace
+
+#endif
@@ -0,0 +1,100 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "indexed_db.hpp"
+#include <libdb/storage_backend.hpp>
+#ifndef __EMSCRIPTEN__
+#include <libdb/fake_indexed_db.hpp>
+#endif
+
+namespace libdb
+{
+
+namespace
+{
+    class indexed_db_storage_backend: public storage_backend
+    {
+        public:
+            void async_read
+            (
+                const char* database_name,
+                const char* store_name,
+                const read_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            ) override
+            {
+                indexed_db::async_read_v2
+                (
+                    database_name,
+                    store_name,
+                    [success_callback](void* data, int size)
+                    {
+                        success_callback(data, size);
+                    },
+                    [failure_callback]
+                    {
+                        failure_callback("IndexedDB read error");
+                    }
+                );
+            }
+
+            void async_write
+            (
+                const char* database_name,
+                const char* store_name,
+                const void* data,
+                int size,
+                const write_success_callback_t& success_callback,
+                const failure_callback_t& failure_callback
+            ) override
+            {
+                indexed_db::async_write_v2
+                (
+                    database_name,
+                    store_name,
+                    const_cast<void*>(data),
+                    size,
+                    success_callback,
+                    [failure_callback]
+                    {
+                        failure_callback("IndexedDB write error");
+                    }
+                );
+            }
+
+#ifndef __EMSCRIPTEN__
+            void poll() override
+            {
+                fake_indexed_db::poll();
+            }
+
+            bool wait() override
+            {
+                return fake_indexed_db::wait();
+            }
+#endif
+    };
+}
+
+std::unique_ptr<storage_backend> make_indexed_db_storage_backend()
+{
+    return std::make_unique<indexed_db_storage_backend>();
+}
+
+} //namespace
@@ -0,0 +1,467 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "json_sax_reader.hpp"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace libdb
+{
+
+namespace
+{
+    using opt_tile = std::optional<data_types::tile>;
+
+    template<std::size_t... Is>
+    data_types::tile make_tile(const std::size_t index, std::index_sequence<Is...>)
+    {
+        using tile_factory_t = data_types::tile(*)();
+        constexpr auto factories = std::array<tile_factory_t, sizeof...(Is)>
+        {
+            []{return data_types::tile{std::in_place_index<Is>};}...
+        };
+        return factories[index]();
+    }
+
+    data_types::tile make_tile(const int type_index, const std::optional<int>& opt_value)
+    {
+        constexpr auto type_count = std::variant_size_v<data_types::tile>;
+
+        if(type_index < 0 || type_index >= static_cast<int>(type_count))
+        {
+            throw std::runtime_error{"Invalid type index: " + std::to_string(type_index)};
+        }
+
+        auto tile = make_tile
+        (
+            static_cast<std::size_t>(type_index),
+            std::make_index_sequence<type_count>{}
+        );
+
+        const auto get_value = [&]
+        {
+            if(!opt_value)
+            {
+                throw std::runtime_error{"Missing tile value"};
+            }
+            return *opt_value;
+        };
+
+        namespace tiles = libgame::data_types::tiles;
+        if(auto ptile = std::get_if<tiles::number>(&tile))
+        {
+            ptile->value = get_value();
+        }
+        else if(auto ptile = std::get_if<tiles::granite>(&tile))
+        {
+            ptile->thickness = get_value();
+        }
+        else if(auto ptile = std::get_if<tiles::adder>(&tile))
+        {
+            ptile->value = get_value();
+        }
+
+        return tile;
+    }
+
+    /*
+    Layouts (see json_conversion.hpp):
+    - v1: root = stage state of purity_chapel, tiles in row-major order in a
+      6-column matrix;
+    - v2: root = {"stageStates": [[stage, stage state], ...]}, tiles in
+      matrix storage order.
+    */
+    class sax_handler: public nlohmann::json_sax<nlohmann::json>
+    {
+        private:
+            //Flags of the required members found in an object or array, so
+            //that incomplete documents are rejected like from_json() does
+            struct found
+            {
+                static constexpr unsigned stage_states     = 1 << 0; //root (v2)
+                static constexpr unsigned hi_score         = 1 << 1; //stage state
+                static constexpr unsigned next_input_tiles = 1 << 2; //stage state
+                static constexpr unsigned input_tiles      = 1 << 3; //stage state
+                static constexpr unsigned board_tiles      = 1 << 4; //stage state
+                static constexpr unsigned stage            = 1 << 5; //stage state pair
+                static constexpr unsigned state            = 1 << 6; //stage state pair
+
+                static constexpr unsigned all_of_root = stage_states;
+                static constexpr unsigned all_of_stage_state = hi_score | next_input_tiles | input_tiles | board_tiles;
+                static constexpr unsigned all_of_stage_state_pair = stage | state;
+            };
+
+            enum class role
+            {
+                root,
+                stage_state_list,
+                stage_state_pair,
+                stage_state,
+                tile_list,
+                tile,
+                ignored
+            };
+
+            struct frame
+            {
+                role r;
+                std::string key = {}; //for objects
+                int index = 0; //for arrays
+                unsigned found_flags = 0;
+
+                //for tile lists
+                std::optional<data_types::tile>* ptiles = nullptr;
+                int tile_count = 0;
+                int col_count = 0;
+                int row_count = 0;
+                int col_stride = 0;
+                int row_stride = 0;
+            };
+
+        public:
+            sax_handler(data_types::game_state& to, const int version):
+                to_(to),
+                version_(version)
+            {
+            }
+
+            bool null() override
+            {
+                on_scalar();
+                return true;
+            }
+
+            bool boolean(bool) override
+            {
+                on_scalar();
+                return true;
+            }
+
+            bool number_integer(const number_integer_t value) override
+            {
+                on_number(static_cast<double>(value));
+                return true;
+            }
+
+            bool number_unsigned(const number_unsigned_t value) override
+            {
+                on_number(static_cast<double>(value));
+                return true;
+            }
+
+            bool number_float(const number_float_t value, const string_t&) override
+            {
+                on_number(value);
+                return true;
+            }
+
+            bool string(string_t&) override
+            {
+                on_scalar();
+                return true;
+            }
+
+            bool binary(binary_t&) override
+            {
+                on_scalar();
+                return true;
+            }
+
+            bool start_object(std::size_t) override
+            {
+                if(frames_.empty())
+                {
+                    if(version_ == 1)
+                    {
+                        pstage_state_ = &to_.stage_states[data_types::stage::purity_chapel];
+                        frames_.push_back(frame{.r = role::stage_state});
+                    }
+                    else
+                    {
+                        frames_.push_back(frame{.r = role::root});
+                    }
+                    return true;
+                }
+
+                auto& parent = frames_.back();
+                auto r = role::ignored;
+
+                if(parent.r == role::stage_state_pair && parent.index == 1)
+                {
+                    if(!opt_stage_)
+                    {
+                        throw std::runtime_error{"Missing stage"};
+                    }
+                    pstage_state_ = &to_.stage_states[*opt_stage_];
+                    parent.found_flags |= found::state;
+                    r = role::stage_state;
+                }
+                else if(parent.r == role::tile_list)
+                {
+                    r = role::tile;
+                    tile_type_ = -1;
+                    opt_tile_value_.reset();
+                }
+
+                ++parent.index;
+                frames_.push_back(frame{.r = r});
+                return true;
+            }
+
+            bool key(string_t& val) override
+            {
+                frames_.back().key = val;
+                return true;
+            }
+
+            bool end_object() override
+            {
+                const auto f = std::move(frames_.back());
+                frames_.pop_back();
+
+                if(f.r == role::root)
+                {
+                    check_found_flags(f, found::all_of_root, "Missing stage states");
+                }
+                else if(f.r == role::stage_state)
+                {
+                    check_found_flags(f, found::all_of_stage_state, "Missing stage state member");
+                }
+                else if(f.r == role::tile)
+                {
+                    //Element index has already been incremented
+                    auto& parent = frames_.back();
+                    if(auto ptile = get_tile(parent, parent.index - 1))
+                    {
+                        *ptile = make_tile(tile_type_, opt_tile_value_);
+                    }
+                }
+
+                return true;
+            }
+
+            bool start_array(std::size_t) override
+            {
+                if(frames_.empty())
+                {
+                    throw std::runtime_error{"Root must be an object"};
+                }
+
+                auto& parent = frames_.back();
+                auto f = frame{.r = role::ignored};
+
+                if(parent.r == role::root && parent.key == "stageStates")
+                {
+                    f.r = role::stage_state_list;
+                    parent.found_flags |= found::stage_states;
+                }
+                else if(parent.r == role::stage_state_list)
+                {
+                    f.r = role::stage_state_pair;
+                    opt_stage_.reset();
+                }
+                else if(parent.r == role::stage_state)
+                {
+                    if(parent.key == "nextInputTiles")
+                    {
+                        set_tile_list(f, pstage_state_->next_input_tiles);
+                        parent.found_flags |= found::next_input_tiles;
+                    }
+                    else if(parent.key == "inputTiles")
+                    {
+                        set_tile_list(f, pstage_state_->input_tiles);
+                        parent.found_flags |= found::input_tiles;
+                    }
+                    else if(parent.key == "boardTiles")
+                    {
+                        set_tile_list(f, pstage_state_->brd.tiles);
+                        parent.found_flags |= found::board_tiles;
+                    }
+                }
+
+                if(parent.r != role::root && parent.r != role::stage_state)
+                {
+                    ++parent.index;
+                }
+
+                frames_.push_back(std::move(f));
+                return true;
+            }
+
+            bool end_array() override
+            {
+                const auto f = std::move(frames_.back());
+                frames_.pop_back();
+
+                if(f.r == role::stage_state_pair)
+                {
+                    check_found_flags(f, found::all_of_stage_state_pair, "Incomplete stage state pair");
+                }
+
+                return true;
+            }
+
+            bool parse_error
+            (
+                std::size_t,
+                const std::string&,
+                const nlohmann::detail::exception& ex
+            ) override
+            {
+                throw std::runtime_error{ex.what()};
+            }
+
+        private:
+            static void check_found_flags(const frame& f, const unsigned required_flags, const char* error)
+            {
+                if((f.found_flags & required_flags) != required_flags)
+                {
+                    throw std::runtime_error{error};
+                }
+            }
+
+            template<class Matrix>
+            static void set_tile_list(frame& f, Matrix& tiles)
+            {
+                f.r = role::tile_list;
+                f.ptiles = tiles.data.data();
+                f.tile_count = static_cast<int>(tiles.data.size());
+                f.col_count = Matrix::cols;
+                f.row_count = Matrix::rows;
+                f.col_stride = Matrix::col_stride;
+                f.row_stride = Matrix::row_stride;
+            }
+
+            //Return nullptr if the element doesn't map to a tile
+            std::optional<data_types::tile>* get_tile(const frame& f, const int element_index) const
+            {
+                if(version_ == 1)
+                {
+                    const auto col = element_index % 6;
+                    const auto row = element_index / 6;
+                    if(col >= f.col_count || row >= f.row_count)
+                    {
+                        return nullptr;
+                    }
+                    return f.ptiles + (col * f.col_stride + row * f.row_stride);
+                }
+
+                if(element_index >= f.tile_count)
+                {
+                    return nullptr;
+                }
+                return f.ptiles + element_index;
+            }
+
+            //Strings, booleans, nulls
+            void on_scalar()
+            {
+                if(!frames_.empty())
+                {
+                    auto& f = frames_.back();
+                    if(f.r == role::tile_list || f.r == role::stage_state_pair || f.r == role::stage_state_list)
+                    {
+                        ++f.index;
+                    }
+                }
+            }
+
+            void on_number(const double value)
+            {
+                if(frames_.empty())
+                {
+                    throw std::runtime_error{"Root must be an object"};
+                }
+
+                auto& f = frames_.back();
+
+                switch(f.r)
+                {
+                    case role::stage_state_pair:
+                        if(f.index == 0)
+                        {
+                            opt_stage_ = static_cast<data_types::stage>(static_cast<int>(value));
+                            f.found_flags |= found::stage;
+                        }
+                        ++f.index;
+                        break;
+                    case role::stage_state:
+                        if(f.key == "hiScore")
+                        {
+                            pstage_state_->hi_score = static_cast<int>(value);
+                            f.found_flags |= found::hi_score;
+                        }
+                        else if(f.key == "moveCount")
+                        {
+                            pstage_state_->move_count = static_cast<int>(value);
+                        }
+                        else if(f.key == "time_s")
+                        {
+                            pstage_state_->time_s = value;
+                        }
+                        break;
+                    case role::tile:
+                        if(f.key == "type")
+                        {
+                            tile_type_ = static_cast<int>(value);
+                        }
+                        else if(f.key == "value")
+                        {
+                            opt_tile_value_ = static_cast<int>(value);
+                        }
+                        break;
+                    case role::tile_list:
+                    case role::stage_state_list:
+                        ++f.index;
+                        break;
+                    case role::root:
+                    case role::ignored:
+                        break;
+                }
+            }
+
+        private:
+            data_types::game_state& to_;
+            const int version_;
+
+            std::vector<frame> frames_;
+            std::optional<data_types::stage> opt_stage_;
+            data_types::stage_state* pstage_state_ = nullptr;
+            int tile_type_ = -1;
+            std::optional<int> opt_tile_value_;
+    };
+}
+
+void from_json_sax(const std::string_view json_str, data_types::game_state& to, const int version)
+{
+    if(version != 1 && version != 2)
+    {
+        throw std::runtime_error{"Unsupported database version"};
+    }
+
+    auto handler = sax_handler{to, version};
+    nlohmann::json::sax_parse(json_str, &handler);
+}
+
+} //namespace
@@ -0,0 +1,37 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDB_JSON_SAX_READER_HPP
+#define LIBDB_JSON_SAX_READER_HPP
+
+#include <libdb/data_types.hpp>
+#include <string_view>
+
+namespace libdb
+{
+    /*
+    Decode given v1 or v2 JSON save (see json_conversion.hpp) in a single
+    pass, filling the stage states in place, without building a DOM.
+    Unknown keys are ignored.
+    Throw if the JSON is invalid or if a required member is missing.
+    */
+    void from_json_sax(std::string_view json_str, data_types::game_state& to, int version);
+}
+
+#endif
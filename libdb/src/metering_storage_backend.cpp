@@ -0,0 +1,168 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "metering_storage_backend.hpp"
+#include <string>
+
+namespace libdb
+{
+
+namespace
+{
+    template<class Duration>
+    std::chrono::microseconds to_us(const Duration d)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d);
+    }
+}
+
+metering_storage_backend::metering_storage_backend
+(
+    std::unique_ptr<storage_backend>&& pbackend,
+    const read_metrics_callback_t& read_metrics_callback
+):
+    pbackend_(std::move(pbackend)),
+    read_metrics_callback_(read_metrics_callback)
+{
+}
+
+void metering_storage_backend::async_read
+(
+    const char* database_name,
+    const char* store_name,
+    const read_success_callback_t& success_callback,
+    const failure_callback_t& failure_callback
+)
+{
+    ++transaction_count_;
+
+    auto metrics = events::read_metrics
+    {
+        .key = store_name,
+        .overlapping_transaction_count = transaction_count_
+    };
+    const auto start_time = clock::now();
+
+    pbackend_->async_read
+    (
+        database_name,
+        store_name,
+        [this, metrics, start_time, success_callback](const void* data, int size) mutable
+        {
+            --transaction_count_;
+
+            const auto callback_time = clock::now();
+            success_callback(data, size);
+
+            metrics.byte_count = data ? static_cast<std::size_t>(size) : 0;
+            metrics.read_duration = to_us(callback_time - start_time);
+            metrics.parse_duration = to_us(clock::now() - callback_time);
+            read_metrics_callback_(metrics);
+        },
+        [this, metrics, start_time, failure_callback](const char* error) mutable
+        {
+            --transaction_count_;
+
+            metrics.read_duration = to_us(clock::now() - start_time);
+            metrics.success = false;
+
+            failure_callback(error);
+            read_metrics_callback_(metrics);
+        }
+    );
+}
+
+void metering_storage_backend::async_write
+(
+    const char* database_name,
+    const char* store_name,
+    const void* data,
+    const int size,
+    const write_success_callback_t& success_callback,
+    const failure_callback_t& failure_callback
+)
+{
+    ++transaction_count_;
+
+    pbackend_->async_write
+    (
+        database_name,
+        store_name,
+        data,
+        size,
+        [this, success_callback]
+        {
+            --transaction_count_;
+            success_callback();
+        },
+        [this, failure_callback](const char* error)
+        {
+            --transaction_count_;
+            failure_callback(error);
+        }
+    );
+}
+
+void metering_storage_backend::async_append
+(
+    const char* database_name,
+    const char* store_name,
+    const void* data,
+    const int size,
+    const write_success_callback_t& success_callback,
+    const failure_callback_t& failure_callback
+)
+{
+    ++transaction_count_;
+
+    pbackend_->async_append
+    (
+        database_name,
+        store_name,
+        data,
+        size,
+        [this, success_callback]
+        {
+            --transaction_count_;
+            success_callback();
+        },
+        [this, failure_callback](const char* error)
+        {
+            --transaction_count_;
+            failure_callback(error);
+        }
+    );
+}
+
+bool metering_storage_backend::has_native_append() const
+{
+    return pbackend_->has_native_append();
+}
+
+void metering_storage_backend::poll()
+{
+    pbackend_->poll();
+}
+
+bool metering_storage_backend::wait()
+{
+    return pbackend_->wait();
+}
+
+} //namespace
@@ -0,0 +1,97 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDB_METERING_STORAGE_BACKEND_HPP
+#define LIBDB_METERING_STORAGE_BACKEND_HPP
+
+#include <libdb/events.hpp>
+#include <libdb/storage_backend.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace libdb
+{
+
+/*
+Storage backend decorator that counts the transactions in flight and
+measures the reads.
+*/
+class metering_storage_backend: public storage_backend
+{
+    public:
+        using read_metrics_callback_t = std::function<void(const events::read_metrics&)>;
+
+        metering_storage_backend
+        (
+            std::unique_ptr<storage_backend>&& pbackend,
+            const read_metrics_callback_t& read_metrics_callback
+        );
+
+        void async_read
+        (
+            const char* database_name,
+            const char* store_name,
+            const read_success_callback_t& success_callback,
+            const failure_callback_t& failure_callback
+        ) override;
+
+        void async_write
+        (
+            const char* database_name,
+            const char* store_name,
+            const void* data,
+            int size,
+            const write_success_callback_t& success_callback,
+            const failure_callback_t& failure_callback
+        ) override;
+
+        void async_append
+        (
+            const char* database_name,
+            const char* store_name,
+            const void* data,
+            int size,
+            const write_success_callback_t& success_callback,
+            const failure_callback_t& failure_callback
+        ) override;
+
+        bool has_native_append() const override;
+
+        void poll() override;
+
+        bool wait() override;
+
+        //Number of transactions that haven't completed yet
+        int get_transaction_count() const
+        {
+            return transaction_count_;
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        std::unique_ptr<storage_backend> pbackend_;
+        read_metrics_callback_t read_metrics_callback_;
+        int transaction_count_ = 0;
+};
+
+} //namespace
+
+#endif
@@ -0,0 +1,239 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "persistence_queue.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace libdb
+{
+
+persistence_queue::persistence_queue
+(
+    metering_storage_backend& backend,
+    const char* database_name,
+    const clock::duration debounce_delay,
+    const clock::duration max_delay,
+    const failure_callback_t& failure_callback,
+    const metrics_callback_t& metrics_callback
+):
+    backend_(backend),
+    database_name_(database_name),
+    debounce_delay_(debounce_delay),
+    max_delay_(max_delay),
+    failure_callback_(failure_callback),
+    metrics_callback_(metrics_callback)
+{
+}
+
+void persistence_queue::push(const std::string& key, const encoder_t& encoder)
+{
+    const auto now = clock::now();
+    auto request_time = now;
+
+    const auto it = std::find_if
+    (
+        pending_entries_.begin(),
+        pending_entries_.end(),
+        [&](const pending_entry& entry)
+        {
+            return entry.key == key;
+        }
+    );
+
+    if(it != pending_entries_.end())
+    {
+        request_time = it->request_time;
+        pending_entries_.erase(it);
+    }
+
+    pending_entries_.push_back(pending_entry{key, encoder, false, request_time});
+    last_push_time_ = now;
+}
+
+void persistence_queue::push_append(const std::string& key, const buffer_t& data)
+{
+    const auto it = std::find_if
+    (
+        pending_entries_.begin(),
+        pending_entries_.end(),
+        [&](const pending_entry& entry)
+        {
+            return entry.key == key;
+        }
+    );
+
+    const auto now = clock::now();
+
+    if(it == pending_entries_.end())
+    {
+        pending_entries_.push_back
+        (
+            pending_entry
+            {
+                key,
+                [data]
+                {
+                    return data;
+                },
+                true,
+                now
+            }
+        );
+    }
+    else
+    {
+        it->encoder = [previous_encoder = std::move(it->encoder), data]
+        {
+            auto buffer = previous_encoder();
+            buffer.insert(buffer.end(), data.begin(), data.end());
+            return buffer;
+        };
+    }
+
+    last_push_time_ = now;
+}
+
+void persistence_queue::advance()
+{
+    if(write_in_flight_ || pending_entries_.empty())
+    {
+        return;
+    }
+
+    const auto now = clock::now();
+
+    if(!flush_requested_)
+    {
+        const auto oldest_request_time = std::min_element
+        (
+            pending_entries_.begin(),
+            pending_entries_.end(),
+            [](const pending_entry& lhs, const pending_entry& rhs)
+            {
+                return lhs.request_time < rhs.request_time;
+            }
+        )->request_time;
+
+        //Write everything that's pending, as the entries may depend on
+        //each other (e.g. a journal and its snapshot)
+        if(now - oldest_request_time >= max_delay_)
+        {
+            flush_requested_ = true;
+        }
+    }
+
+    if(flush_requested_ || now - last_push_time_ >= debounce_delay_)
+    {
+        start_next_write();
+    }
+}
+
+void persistence_queue::flush()
+{
+    if(pending_entries_.empty())
+    {
+        return;
+    }
+
+    flush_requested_ = true;
+
+    if(!write_in_flight_)
+    {
+        start_next_write();
+    }
+}
+
+bool persistence_queue::is_idle() const
+{
+    return !write_in_flight_ && pending_entries_.empty();
+}
+
+void persistence_queue::start_next_write()
+{
+    auto entry = std::move(pending_entries_.front());
+    pending_entries_.erase(pending_entries_.begin());
+    const auto& key = entry.key;
+
+    if(pending_entries_.empty())
+    {
+        flush_requested_ = false;
+    }
+
+    //Keep the buffer alive until the end of the write
+    const auto encode_start_time = clock::now();
+    auto pbuffer = std::make_shared<const buffer_t>(entry.encoder());
+    const auto write_start_time = clock::now();
+
+    auto metrics = events::write_metrics
+    {
+        .key = key,
+        .byte_count = pbuffer->size(),
+        .append = entry.append,
+        .encode_duration = std::chrono::duration_cast<std::chrono::microseconds>(write_start_time - encode_start_time),
+        .overlapping_transaction_count = backend_.get_transaction_count() + 1
+    };
+
+    const auto complete_metrics = [request_time = entry.request_time, write_start_time](events::write_metrics& metrics, const bool success)
+    {
+        const auto now = clock::now();
+        metrics.request_to_completion_duration = std::chrono::duration_cast<std::chrono::microseconds>(now - request_time);
+        metrics.write_duration = std::chrono::duration_cast<std::chrono::microseconds>(now - write_start_time);
+        metrics.success = success;
+    };
+
+    write_in_flight_ = true;
+
+    const auto write_fn = entry.append ? &storage_backend::async_append : &storage_backend::async_write;
+    (backend_.*write_fn)
+    (
+        database_name_.c_str(),
+        key.c_str(),
+        pbuffer->data(),
+        static_cast<int>(pbuffer->size()),
+        [this, pbuffer, metrics, complete_metrics]() mutable
+        {
+            write_in_flight_ = false;
+
+            complete_metrics(metrics, true);
+            metrics_callback_(metrics);
+
+            //Don't wait for the next frame if we're flushing
+            if(flush_requested_)
+            {
+                start_next_write();
+            }
+        },
+        [this, pbuffer, metrics, complete_metrics](const char* error) mutable
+        {
+            write_in_flight_ = false;
+
+            complete_metrics(metrics, false);
+            metrics_callback_(metrics);
+            failure_callback_(metrics.key, error);
+
+            if(flush_requested_)
+            {
+                start_next_write();
+            }
+        }
+    );
+}
+
+} //namespace
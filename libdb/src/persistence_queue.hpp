@@ -0,0 +1,112 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDB_PERSISTENCE_QUEUE_HPP
+#define LIBDB_PERSISTENCE_QUEUE_HPP
+
+#include "metering_storage_backend.hpp"
+#include <libdb/events.hpp>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace libdb
+{
+
+/*
+Writes entries of a database to a storage backend, one at a time.
+
+Entries are pushed as encoders, which are only called when the write of the
+entry starts. Pushing an entry that is already pending replaces it, so that
+only the latest version is encoded and written. Appends to a pending entry
+are merged into it.
+
+Entries are written in the order they were (last) pushed.
+
+Pending entries are written once no entry has been pushed for the debounce
+delay, once the oldest pending request is older than the max delay (so that
+continuous pushes don't postpone writes forever), or as soon as possible after
+a call to flush().
+
+The metrics of each write are given to the metrics callback.
+*/
+class persistence_queue
+{
+    public:
+        using buffer_t = std::vector<std::byte>;
+        using encoder_t = std::function<buffer_t()>;
+        using failure_callback_t = std::function<void(const std::string& key, const char* error)>;
+        using metrics_callback_t = std::function<void(const events::write_metrics&)>;
+        using clock = std::chrono::steady_clock;
+
+        persistence_queue
+        (
+            metering_storage_backend& backend,
+            const char* database_name,
+            clock::duration debounce_delay,
+            clock::duration max_delay,
+            const failure_callback_t& failure_callback,
+            const metrics_callback_t& metrics_callback
+        );
+
+        void push(const std::string& key, const encoder_t& encoder);
+
+        void push_append(const std::string& key, const buffer_t& data);
+
+        //Start the next write if it's time to. Call once per frame.
+        void advance();
+
+        //Write all the pending entries without waiting for the debounce delay
+        void flush();
+
+        //No pending entry and no write in flight
+        bool is_idle() const;
+
+    private:
+        struct pending_entry
+        {
+            std::string key;
+            encoder_t encoder;
+            bool append = false;
+
+            //Of the first push of the entry
+            clock::time_point request_time;
+        };
+
+        void start_next_write();
+
+    private:
+        metering_storage_backend& backend_;
+        const std::string database_name_;
+        const clock::duration debounce_delay_;
+        const clock::duration max_delay_;
+        failure_callback_t failure_callback_;
+        metrics_callback_t metrics_callback_;
+
+        std::vector<pending_entry> pending_entries_;
+        clock::time_point last_push_time_;
+        bool flush_requested_ = false;
+        bool write_in_flight_ = false;
+};
+
+} //namespace
+
+#endif
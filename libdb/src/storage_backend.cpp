@@ -0,0 +1,111 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <libdb/storage_backend.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libdb
+{
+
+#ifndef __EMSCRIPTEN__
+namespace
+{
+    //$XDG_DATA_HOME/ternarii, or ~/.local/share/ternarii, or ./ternarii
+    std::filesystem::path get_default_data_dir()
+    {
+        if(const auto xdg_data_home = std::getenv("XDG_DATA_HOME"); xdg_data_home && *xdg_data_home)
+        {
+            return std::filesystem::path{xdg_data_home} / "ternarii";
+        }
+
+        if(const auto home = std::getenv("HOME"); home && *home)
+        {
+            return std::filesystem::path{home} / ".local" / "share" / "ternarii";
+        }
+
+        return "ternarii";
+    }
+}
+#endif
+
+std::unique_ptr<storage_backend> make_default_storage_backend()
+{
+#ifdef __EMSCRIPTEN__
+    return make_indexed_db_storage_backend();
+#else
+    return make_file_storage_backend(get_default_data_dir());
+#endif
+}
+
+void storage_backend::async_append
+(
+    const char* database_name,
+    const char* store_name,
+    const void* data,
+    const int size,
+    const write_success_callback_t& success_callback,
+    const failure_callback_t& failure_callback
+)
+{
+    async_read
+    (
+        database_name,
+        store_name,
+        [
+            this,
+            database_name = std::string{database_name},
+            store_name = std::string{store_name},
+            data,
+            size,
+            success_callback,
+            failure_callback
+        ](const void* old_data, const int old_size)
+        {
+            const auto pold_data = static_cast<const std::byte*>(old_data);
+            const auto pdata = static_cast<const std::byte*>(data);
+
+            //Keep the buffer alive until the end of the write
+            auto pbuffer = std::make_shared<std::vector<std::byte>>(pold_data, pold_data + old_size);
+            pbuffer->insert(pbuffer->end(), pdata, pdata + size);
+
+            async_write
+            (
+                database_name.c_str(),
+                store_name.c_str(),
+                pbuffer->data(),
+                static_cast<int>(pbuffer->size()),
+                [pbuffer, success_callback]
+                {
+                    success_callback();
+                },
+                [pbuffer, failure_callback](const char* error)
+                {
+                    failure_callback(error);
+                }
+            );
+        },
+        failure_callback
+    );
+}
+
+} //namespace
@@ -49,6 +49,18 @@ struct game
             event_list& events
         );
 
+        /*
+        Same as drop_input_tiles(), except that the new next input is the given
+        one instead of a generated one.
+        Used to replay recorded moves.
+        */
+        void replay_input_tiles_drop
+        (
+            const data_types::input_layout& layout,
+            const data_types::input_tile_matrix& next_input_tiles,
+            event_list& events
+        );
+
         void advance(double elapsed_s);
 
     private:
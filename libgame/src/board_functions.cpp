@@ -20,21 +20,22 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <libgame/board_functions.hpp>
 #include <libgame/constants.hpp>
 #include <libutil/overload.hpp>
+#include <algorithm>
 
 namespace libgame::data_types
 {
 
-int get_tile_count(const board& brd)
+namespace
 {
-    auto count = 0;
-    for(const auto& opt_tile: brd.tiles)
+    bool has_value(const std::optional<tile>& opt_tile)
     {
-        if(opt_tile)
-        {
-            ++count;
-        }
+        return opt_tile.has_value();
     }
-    return count;
+}
+
+int get_tile_count(const board& brd)
+{
+    return static_cast<int>(libutil::get_mask(brd.tiles, has_value).count());
 }
 
 std::optional<int> get_lowest_empty_cell
@@ -43,9 +44,10 @@ std::optional<int> get_lowest_empty_cell
     const int col
 )
 {
-    for(auto row = 0; row < brd.tiles.rows; ++row)
+    const auto tiles = libutil::get_col(brd.tiles, col);
+    for(auto row = 0; row < tiles.size(); ++row)
     {
-        if(!at(brd.tiles, col, row))
+        if(!tiles[row])
         {
             return row;
         }
@@ -56,15 +58,8 @@ std::optional<int> get_lowest_empty_cell
 
 bool is_overflowed(const board& brd)
 {
-    for(int col = 0; col < brd.tiles.cols; ++col)
-    {
-        if(at(brd.tiles, col, constants::board_authorized_row_count))
-        {
-            return true;
-        }
-    }
-
-    return false;
+    const auto tiles = libutil::get_row(brd.tiles, constants::board_authorized_row_count);
+    return std::any_of(tiles.begin(), tiles.end(), has_value);
 }
 
 int get_highest_tile_value(const board& brd)
@@ -223,9 +218,10 @@ apply_nullifiers_result apply_nullifiers(const board& brd)
                     [&](const tiles::column_nullifier&)
                     {
                         //Remove all tiles from current column
-                        for(int nullified_row = 0; nullified_row < result.brd.tiles.rows; ++nullified_row)
+                        const auto tiles = libutil::get_col(result.brd.tiles, col);
+                        for(int nullified_row = 0; nullified_row < tiles.size(); ++nullified_row)
                         {
-                            auto& opt_tile = at(result.brd.tiles, col, nullified_row);
+                            auto& opt_tile = tiles[nullified_row];
 
                             if(!opt_tile)
                             {
@@ -248,9 +244,10 @@ apply_nullifiers_result apply_nullifiers(const board& brd)
                         static const auto columns = std::vector<int>({0, 5});
                         for(const auto column: columns)
                         {
-                            for(int nullified_row = 0; nullified_row < result.brd.tiles.rows; ++nullified_row)
+                            const auto tiles = libutil::get_col(result.brd.tiles, column);
+                            for(int nullified_row = 0; nullified_row < tiles.size(); ++nullified_row)
                             {
-                                auto& opt_tile = at(result.brd.tiles, column, nullified_row);
+                                auto& opt_tile = tiles[nullified_row];
 
                                 if(!opt_tile)
                                 {
@@ -267,9 +264,10 @@ apply_nullifiers_result apply_nullifiers(const board& brd)
                     [&](const tiles::row_nullifier&)
                     {
                         //Remove all tiles from current row
-                        for(int nullified_col = 0; nullified_col < result.brd.tiles.cols; ++nullified_col)
+                        const auto tiles = libutil::get_row(result.brd.tiles, row);
+                        for(int nullified_col = 0; nullified_col < tiles.size(); ++nullified_col)
                         {
-                            auto& opt_tile = at(result.brd.tiles, nullified_col, row);
+                            auto& opt_tile = tiles[nullified_col];
 
                             if(!opt_tile)
                             {
@@ -58,6 +58,14 @@ struct game::impl
         };
     }
 
+    template<class NextInputCreator>
+    void drop_input_tiles
+    (
+        const data_types::input_layout& layout,
+        event_list& events,
+        NextInputCreator&& create_next_input
+    );
+
     abstract_input_generator& input_gen;
     data_types::stage_state state;
 };
@@ -106,13 +114,15 @@ void game::start(event_list& events)
     events.push_back(pimpl_->generate_next_input());
 }
 
-void game::drop_input_tiles
+template<class NextInputCreator>
+void game::impl::drop_input_tiles
 (
     const data_types::input_layout& layout,
-    event_list& events
+    event_list& events,
+    NextInputCreator&& create_next_input
 )
 {
-    if(is_over())
+    if(is_overflowed(state.brd))
     {
         return;
     }
@@ -121,28 +131,28 @@ void game::drop_input_tiles
     {
         auto result = libgame::data_types::drop_input_tiles
         (
-            pimpl_->state.brd,
-            pimpl_->state.input_tiles,
+            state.brd,
+            state.input_tiles,
             layout
         );
 
-        pimpl_->state.brd = result.brd;
+        state.brd = result.brd;
 
         for(const auto& event: result.events)
             events.push_back(event);
     }
 
-    auto& move_count = pimpl_->state.move_count;
+    auto& move_count = state.move_count;
     ++move_count;
     events.push_back(events::move_count_change{move_count});
 
-    if(is_over())
+    if(is_overflowed(state.brd))
     {
         events.push_back(events::end_of_game{});
 
         //Save hi-score
-        const auto score = get_score(pimpl_->state.brd);
-        auto& hi_score = pimpl_->state.hi_score;
+        const auto score = get_score(state.brd);
+        auto& hi_score = state.hi_score;
         if(hi_score < score)
         {
             hi_score = score;
@@ -152,14 +162,50 @@ void game::drop_input_tiles
     else
     {
         //move the next input into the input
-        pimpl_->state.input_tiles = pimpl_->state.next_input_tiles;
+        state.input_tiles = state.next_input_tiles;
         events.push_back(events::next_input_insertion{});
 
         //create a new next input
-        events.push_back(pimpl_->generate_next_input());
+        events.push_back(create_next_input());
     }
 }
 
+void game::drop_input_tiles
+(
+    const data_types::input_layout& layout,
+    event_list& events
+)
+{
+    pimpl_->drop_input_tiles
+    (
+        layout,
+        events,
+        [this]
+        {
+            return pimpl_->generate_next_input();
+        }
+    );
+}
+
+void game::replay_input_tiles_drop
+(
+    const data_types::input_layout& layout,
+    const data_types::input_tile_matrix& next_input_tiles,
+    event_list& events
+)
+{
+    pimpl_->drop_input_tiles
+    (
+        layout,
+        events,
+        [&]
+        {
+            pimpl_->state.next_input_tiles = next_input_tiles;
+            return events::next_input_creation{next_input_tiles};
+        }
+    );
+}
+
 void game::advance(const double elapsed_s)
 {
     if(is_over())
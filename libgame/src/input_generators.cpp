@@ -19,6 +19,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "input_generators.hpp"
 #include <libutil/rng.hpp>
+#include <algorithm>
 #include <memory>
 
 namespace libgame
@@ -0,0 +1,431 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBUTIL_FORMAT_HPP
+#define LIBUTIL_FORMAT_HPP
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+/*
+Allocation-free formatting into a caller-provided buffer.
+
+Example:
+    auto buffer = std::array<char, 32>{};
+    const auto str = libutil::format_to(buffer, "{} moves, {:n} points", 12, 1234567);
+    //str == "12 moves, 1 234 567 points"
+
+Replacement fields:
+    {}     default formatting
+    {:N}   right-aligned in a field of N characters, padded with spaces
+    {:0N}  same, padded with zeros
+    {:n}   digit grouping (integers only), e.g. "1 234 567"
+    {:nN}  digit grouping and width
+    {{     literal '{'
+    }}     literal '}'
+
+Supported argument types are integers, floating-point numbers, bool, char and
+everything that converts to std::string_view.
+
+The format string is checked at compile time, against the number and types of
+the arguments.
+Output that doesn't fit in the buffer is truncated.
+*/
+
+namespace libutil
+{
+
+namespace format_detail
+{
+    struct spec
+    {
+        int width = 0;
+        bool zero_padding = false;
+        bool digit_grouping = false;
+    };
+
+    //Parse the spec of a replacement field (what's between ':' and '}').
+    constexpr bool parse_spec(const std::string_view str, spec& s)
+    {
+        auto i = std::size_t{0};
+
+        if(i < str.size() && str[i] == 'n')
+        {
+            s.digit_grouping = true;
+            ++i;
+        }
+
+        if(i < str.size() && str[i] == '0')
+        {
+            s.zero_padding = true;
+            ++i;
+        }
+
+        for(; i < str.size(); ++i)
+        {
+            if(str[i] < '0' || str[i] > '9')
+            {
+                return false;
+            }
+            s.width = s.width * 10 + (str[i] - '0');
+        }
+
+        return true;
+    }
+
+    /*
+    Parse the given format string.
+    Call on_literal(std::string_view) for each literal part and
+    on_field(const spec&) for each replacement field, in order.
+    Return false if the format string is invalid.
+    */
+    template<class LiteralHandler, class FieldHandler>
+    constexpr bool parse
+    (
+        const std::string_view fmt,
+        LiteralHandler&& on_literal,
+        FieldHandler&& on_field
+    )
+    {
+        auto literal_begin = std::size_t{0};
+        auto i = std::size_t{0};
+
+        while(i < fmt.size())
+        {
+            const auto c = fmt[i];
+
+            if(c == '{' || c == '}')
+            {
+                if(i != literal_begin)
+                {
+                    on_literal(fmt.substr(literal_begin, i - literal_begin));
+                }
+
+                //Escaped brace
+                if(i + 1 < fmt.size() && fmt[i + 1] == c)
+                {
+                    on_literal(fmt.substr(i, 1));
+                    i += 2;
+                    literal_begin = i;
+                    continue;
+                }
+
+                if(c == '}')
+                {
+                    return false;
+                }
+
+                const auto field_end = fmt.find('}', i);
+                if(field_end == std::string_view::npos)
+                {
+                    return false;
+                }
+
+                auto s = spec{};
+                const auto field = fmt.substr(i + 1, field_end - i - 1);
+                if(!field.empty())
+                {
+                    if(field[0] != ':' || !parse_spec(field.substr(1), s))
+                    {
+                        return false;
+                    }
+                }
+
+                on_field(s);
+
+                i = field_end + 1;
+                literal_begin = i;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        if(i != literal_begin)
+        {
+            on_literal(fmt.substr(literal_begin, i - literal_begin));
+        }
+
+        return true;
+    }
+
+    template<class T>
+    constexpr bool is_integer_v =
+        std::is_integral_v<T> &&
+        !std::is_same_v<T, bool> &&
+        !std::is_same_v<T, char>
+    ;
+
+    template<class T>
+    constexpr bool is_supported_v =
+        std::is_arithmetic_v<T> ||
+        std::is_convertible_v<const T&, std::string_view>
+    ;
+
+    //Called from consteval functions to make them fail
+    void invalid_format_string();
+    void wrong_argument_count();
+    void digit_grouping_on_non_integer();
+
+    //Writes into a char buffer, truncating what doesn't fit
+    class output
+    {
+        public:
+            output(const std::span<char> buffer):
+                begin_(buffer.data()),
+                pos_(buffer.data()),
+                end_(buffer.data() + buffer.size())
+            {
+            }
+
+            void put(const char c)
+            {
+                if(pos_ != end_)
+                {
+                    *pos_++ = c;
+                }
+            }
+
+            void put(const std::string_view str)
+            {
+                for(const auto c: str)
+                {
+                    put(c);
+                }
+            }
+
+            void put_padded(const std::string_view str, const spec& s)
+            {
+                const auto fill = s.zero_padding ? '0' : ' ';
+                auto str_pos = std::size_t{0};
+
+                //Zeros go after the sign
+                if(s.zero_padding && !str.empty() && str[0] == '-')
+                {
+                    put('-');
+                    ++str_pos;
+                }
+
+                for(auto i = static_cast<int>(str.size()); i < s.width; ++i)
+                {
+                    put(fill);
+                }
+
+                put(str.substr(str_pos));
+            }
+
+            std::string_view get_string() const
+            {
+                return std::string_view{begin_, static_cast<std::size_t>(pos_ - begin_)};
+            }
+
+        private:
+            char* begin_;
+            char* pos_;
+            char* end_;
+    };
+
+    template<class T>
+    void write_integer(output& out, const T value, const spec& s)
+    {
+        auto digits = std::array<char, 24>{};
+        const auto [digits_end, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        auto str = std::string_view{digits.data(), static_cast<std::size_t>(digits_end - digits.data())};
+
+        if(!s.digit_grouping)
+        {
+            out.put_padded(str, s);
+            return;
+        }
+
+        //Add a space every 3 digits, starting from the right
+        auto grouped = std::array<char, 32>{};
+        auto grouped_begin = grouped.data() + grouped.size();
+        const auto is_negative = !str.empty() && str[0] == '-';
+        const auto first_digit = is_negative ? std::size_t{1} : std::size_t{0};
+        auto digit_index = 0;
+        for(auto i = str.size(); i > first_digit; --i, ++digit_index)
+        {
+            if(digit_index != 0 && digit_index % 3 == 0)
+            {
+                *--grouped_begin = ' ';
+            }
+            *--grouped_begin = str[i - 1];
+        }
+        if(is_negative)
+        {
+            *--grouped_begin = '-';
+        }
+
+        out.put_padded
+        (
+            std::string_view
+            {
+                grouped_begin,
+                static_cast<std::size_t>(grouped.data() + grouped.size() - grouped_begin)
+            },
+            s
+        );
+    }
+
+    template<class T>
+    void write_arg(output& out, const void* parg, const spec& s)
+    {
+        const auto& arg = *static_cast<const T*>(parg);
+
+        if constexpr(std::is_same_v<T, bool>)
+        {
+            out.put_padded(arg ? "true" : "false", s);
+        }
+        else if constexpr(std::is_same_v<T, char>)
+        {
+            out.put_padded(std::string_view{&arg, 1}, s);
+        }
+        else if constexpr(is_integer_v<T>)
+        {
+            write_integer(out, arg, s);
+        }
+        else if constexpr(std::is_floating_point_v<T>)
+        {
+            auto chars = std::array<char, 32>{};
+            const auto [chars_end, ec] = std::to_chars(chars.data(), chars.data() + chars.size(), arg);
+            out.put_padded
+            (
+                std::string_view{chars.data(), static_cast<std::size_t>(chars_end - chars.data())},
+                s
+            );
+        }
+        else
+        {
+            out.put_padded(std::string_view{arg}, s);
+        }
+    }
+
+    using arg_writer_t = void(*)(output& out, const void* parg, const spec& s);
+}
+
+//Format string whose validity is checked at compile time
+template<class... Args>
+class basic_format_string
+{
+    public:
+        template<class T>
+        requires std::convertible_to<const T&, std::string_view>
+        consteval basic_format_string(const T& str):
+            str_(str)
+        {
+            constexpr bool is_integer_arg[] = {format_detail::is_integer_v<Args>..., false};
+
+            auto field_count = std::size_t{0};
+            auto digit_grouping_on_non_integer = false;
+
+            const auto valid = format_detail::parse
+            (
+                str_,
+                [](std::string_view){},
+                [&](const format_detail::spec& s)
+                {
+                    if(field_count < sizeof...(Args) && s.digit_grouping && !is_integer_arg[field_count])
+                    {
+                        digit_grouping_on_non_integer = true;
+                    }
+                    ++field_count;
+                }
+            );
+
+            if(!valid)
+            {
+                format_detail::invalid_format_string();
+            }
+
+            if(field_count != sizeof...(Args))
+            {
+                format_detail::wrong_argument_count();
+            }
+
+            if(digit_grouping_on_non_integer)
+            {
+                format_detail::digit_grouping_on_non_integer();
+            }
+        }
+
+        constexpr std::string_view get() const
+        {
+            return str_;
+        }
+
+    private:
+        std::string_view str_;
+};
+
+template<class... Args>
+using format_string = basic_format_string<std::type_identity_t<Args>...>;
+
+/*
+Format the given arguments into the given buffer.
+Return the written string (which is a view on the buffer).
+*/
+template<class... Args>
+std::string_view format_to
+(
+    const std::span<char> buffer,
+    const format_string<Args...> fmt,
+    const Args&... args
+)
+{
+    static_assert
+    (
+        (format_detail::is_supported_v<Args> && ...),
+        "Unsupported argument type"
+    );
+
+    const auto arg_ptrs = std::array<const void*, sizeof...(Args)>{&args...};
+    const auto arg_writers = std::array<format_detail::arg_writer_t, sizeof...(Args)>
+    {
+        &format_detail::write_arg<Args>...
+    };
+
+    auto out = format_detail::output{buffer};
+    auto field_index = std::size_t{0};
+
+    format_detail::parse
+    (
+        fmt.get(),
+        [&](const std::string_view literal)
+        {
+            out.put(literal);
+        },
+        [&](const format_detail::spec& s)
+        {
+            arg_writers[field_index](out, arg_ptrs[field_index], s);
+            ++field_index;
+        }
+    );
+
+    return out.get_string();
+}
+
+} //namespace
+
+#endif
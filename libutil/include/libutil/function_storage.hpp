@@ -0,0 +1,253 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBUTIL_FUNCTION_STORAGE_HPP
+#define LIBUTIL_FUNCTION_STORAGE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace libutil::detail
+{
+
+/*
+Type-erased storage of a function object, used by unique_function and
+void_function.
+
+Function objects that fit in inline_size bytes (and that are nothrow-movable)
+are stored in place. Bigger ones are heap-allocated.
+
+The function object is called through a plain function pointer (no virtual
+call).
+
+If Copyable is true, the storage is copyable and only accepts copyable
+function objects. Otherwise, it's move-only.
+*/
+
+template<class Signature, bool Copyable>
+class function_storage;
+
+template<bool Copyable, class R, class... Args>
+class function_storage<R(Args...), Copyable>
+{
+    public:
+        static constexpr auto inline_size = std::size_t{48};
+        static constexpr auto inline_alignment = alignof(std::max_align_t);
+
+    private:
+        enum class operation
+        {
+            copy,
+            move,
+            destroy
+        };
+
+        using invoker_t = R(*)(void* pbuffer, Args&&... args);
+        using manager_t = void(*)(operation op, void* pdst, void* psrc);
+
+        template<class F>
+        static constexpr bool is_inline_storable =
+            sizeof(F) <= inline_size &&
+            alignof(F) <= inline_alignment &&
+            std::is_nothrow_move_constructible_v<F>
+        ;
+
+        //Operations on a function object stored in the buffer
+        template<class F>
+        struct inline_ops
+        {
+            static F& get(void* pbuffer)
+            {
+                return *std::launder(reinterpret_cast<F*>(pbuffer));
+            }
+
+            static R invoke(void* pbuffer, Args&&... args)
+            {
+                return get(pbuffer)(std::forward<Args>(args)...);
+            }
+
+            static void manage(const operation op, void* pdst, void* psrc)
+            {
+                switch(op)
+                {
+                    case operation::copy:
+                        if constexpr(Copyable)
+                            ::new(pdst) F(get(psrc));
+                        break;
+                    case operation::move:
+                        ::new(pdst) F(std::move(get(psrc)));
+                        get(psrc).~F();
+                        break;
+                    case operation::destroy:
+                        get(pdst).~F();
+                        break;
+                }
+            }
+        };
+
+        //Operations on a heap-allocated function object whose address is
+        //stored in the buffer
+        template<class F>
+        struct heap_ops
+        {
+            static F*& get(void* pbuffer)
+            {
+                return *std::launder(reinterpret_cast<F**>(pbuffer));
+            }
+
+            static R invoke(void* pbuffer, Args&&... args)
+            {
+                return (*get(pbuffer))(std::forward<Args>(args)...);
+            }
+
+            static void manage(const operation op, void* pdst, void* psrc)
+            {
+                switch(op)
+                {
+                    case operation::copy:
+                        if constexpr(Copyable)
+                            ::new(pdst) F*(new F(*get(psrc)));
+                        break;
+                    case operation::move:
+                        ::new(pdst) F*(get(psrc));
+                        break;
+                    case operation::destroy:
+                        delete get(pdst);
+                        break;
+                }
+            }
+        };
+
+    public:
+        function_storage() = default;
+
+        template<class F>
+        function_storage(std::in_place_t, F&& f)
+        {
+            using fn_t = std::decay_t<F>;
+
+            static_assert
+            (
+                !Copyable || std::is_copy_constructible_v<fn_t>,
+                "Function object must be copy-constructible"
+            );
+
+            if constexpr(is_inline_storable<fn_t>)
+            {
+                ::new(buffer_) fn_t(std::forward<F>(f));
+                invoker_ = &inline_ops<fn_t>::invoke;
+                manager_ = &inline_ops<fn_t>::manage;
+            }
+            else
+            {
+                ::new(buffer_) fn_t*(new fn_t(std::forward<F>(f)));
+                invoker_ = &heap_ops<fn_t>::invoke;
+                manager_ = &heap_ops<fn_t>::manage;
+            }
+        }
+
+        function_storage(const function_storage& other) requires Copyable
+        {
+            //Only take ownership once the copy has succeeded (it may throw)
+            if(other.manager_)
+            {
+                other.manager_(operation::copy, buffer_, const_cast<std::byte*>(other.buffer_));
+                invoker_ = other.invoker_;
+                manager_ = other.manager_;
+            }
+        }
+
+        function_storage(function_storage&& other) noexcept:
+            invoker_(other.invoker_),
+            manager_(other.manager_)
+        {
+            if(manager_)
+            {
+                manager_(operation::move, buffer_, other.buffer_);
+                other.invoker_ = nullptr;
+                other.manager_ = nullptr;
+            }
+        }
+
+        ~function_storage()
+        {
+            reset();
+        }
+
+        function_storage& operator=(const function_storage& other) requires Copyable
+        {
+            if(this != &other)
+            {
+                auto tmp = function_storage{other};
+                *this = std::move(tmp);
+            }
+            return *this;
+        }
+
+        function_storage& operator=(function_storage&& other) noexcept
+        {
+            if(this != &other)
+            {
+                reset();
+                invoker_ = other.invoker_;
+                manager_ = other.manager_;
+                if(manager_)
+                {
+                    manager_(operation::move, buffer_, other.buffer_);
+                    other.invoker_ = nullptr;
+                    other.manager_ = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        bool is_empty() const
+        {
+            return invoker_ == nullptr;
+        }
+
+        R operator()(Args... args)
+        {
+            assert(invoker_);
+            return invoker_(buffer_, std::forward<Args>(args)...);
+        }
+
+    private:
+        void reset()
+        {
+            if(manager_)
+            {
+                manager_(operation::destroy, buffer_, nullptr);
+                invoker_ = nullptr;
+                manager_ = nullptr;
+            }
+        }
+
+    private:
+        alignas(inline_alignment) std::byte buffer_[inline_size];
+        invoker_t invoker_ = nullptr;
+        manager_t manager_ = nullptr;
+};
+
+} //namespace
+
+#endif
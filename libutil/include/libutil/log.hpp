@@ -21,24 +21,181 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBUTIL_LOG_HPP
 
 #include "streamable.hpp"
+#include <cstddef>
+#include <new>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <iostream>
 
+/*
+Minimum level of the log calls that are compiled in. Calls of lower levels
+are removed at compile time.
+Set from CMake through the LIBUTIL_LOG_MIN_LEVEL cache variable.
+*/
+#ifndef LIBUTIL_LOG_MIN_LEVEL
+#define LIBUTIL_LOG_MIN_LEVEL info
+#endif
+
+/*
+Log calls don't format anything. They copy their arguments into a ring buffer.
+The records of the ring buffer are formatted and written by a background
+thread, or by advance() when threads aren't available (i.e. on Emscripten
+builds without pthread support).
+
+Log functions must be called from a single thread (the main thread).
+*/
+
 namespace libutil::log
 {
 
+enum class level
+{
+    info,
+    error,
+    none
+};
+
+constexpr auto min_level = level::LIBUTIL_LOG_MIN_LEVEL;
+
 void enable();
 
 bool is_enabled();
 
+//To be called once per frame.
+//Format and write the pending records if there's no background thread.
+void advance();
+
+//Format and write all the pending records. Wait for the background thread to
+//do it if there's one.
+void flush();
+
 namespace detail
 {
+    using record_writer_t = void(*)(std::ostream& os, std::byte* payload);
+
+    //Reserve a record of given payload size in the ring buffer.
+    //Return the address of the payload, or nullptr if the buffer is full (in
+    //which case the record is dropped).
+    std::byte* begin_record(level lvl, record_writer_t writer, std::size_t payload_size);
+
+    //Make the record reserved by the last call to begin_record() available
+    //to the consumer.
+    void commit_record();
+
+    constexpr std::size_t align_offset(const std::size_t offset, const std::size_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /*
+    An arg_codec copies an argument into a record payload (encode()), and
+    writes and destroys it afterwards (decode()).
+    */
+
+    //General case: copy of the object
+    template<class T>
+    struct arg_codec
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+
+        static std::size_t get_size(const std::size_t offset, const T&)
+        {
+            return align_offset(offset, alignof(T)) + sizeof(T);
+        }
+
+        static std::size_t encode(std::byte* payload, std::size_t offset, const T& value)
+        {
+            offset = align_offset(offset, alignof(T));
+            ::new(payload + offset) T(value);
+            return offset + sizeof(T);
+        }
+
+        static std::size_t decode(std::ostream& os, std::byte* payload, std::size_t offset)
+        {
+            offset = align_offset(offset, alignof(T));
+            auto& value = *std::launder(reinterpret_cast<T*>(payload + offset));
+            os << streamable{value};
+            value.~T();
+            return offset + sizeof(T);
+        }
+    };
+
+    //Strings: copy of the characters, prefixed with the length
+    struct string_arg_codec
+    {
+        static std::size_t get_size(const std::size_t offset, const std::string_view str)
+        {
+            return align_offset(offset, alignof(std::size_t)) + sizeof(std::size_t) + str.size();
+        }
+
+        static std::size_t encode(std::byte* payload, std::size_t offset, const std::string_view str)
+        {
+            offset = align_offset(offset, alignof(std::size_t));
+            ::new(payload + offset) std::size_t(str.size());
+            offset += sizeof(std::size_t);
+            str.copy(reinterpret_cast<char*>(payload + offset), str.size());
+            return offset + str.size();
+        }
+
+        static std::size_t decode(std::ostream& os, std::byte* payload, std::size_t offset)
+        {
+            offset = align_offset(offset, alignof(std::size_t));
+            const auto size = *std::launder(reinterpret_cast<std::size_t*>(payload + offset));
+            offset += sizeof(std::size_t);
+            os << std::string_view{reinterpret_cast<const char*>(payload + offset), size};
+            return offset + size;
+        }
+    };
+
+    template<>
+    struct arg_codec<char*>: string_arg_codec{};
+
+    template<>
+    struct arg_codec<const char*>: string_arg_codec{};
+
+    template<>
+    struct arg_codec<std::string>: string_arg_codec{};
+
+    template<>
+    struct arg_codec<std::string_view>: string_arg_codec{};
+
     template<class... Args>
-    void log_to(std::ostream& os, const Args&... args)
+    void write_record(std::ostream& os, std::byte* payload)
     {
-        if(is_enabled())
+        auto offset = std::size_t{0};
+        ((offset = arg_codec<Args>::decode(os, payload, offset)), ...);
+    }
+
+    template<level Level, class... Args>
+    void log(const Args&... args)
+    {
+        if constexpr(Level >= min_level)
         {
-            (os << ... << streamable{args}) << std::endl;
+            if(!is_enabled())
+            {
+                return;
+            }
+
+            auto payload_size = std::size_t{0};
+            ((payload_size = arg_codec<std::decay_t<Args>>::get_size(payload_size, args)), ...);
+
+            const auto payload = begin_record
+            (
+                Level,
+                &write_record<std::decay_t<Args>...>,
+                payload_size
+            );
+
+            if(!payload)
+            {
+                return;
+            }
+
+            auto offset = std::size_t{0};
+            ((offset = arg_codec<std::decay_t<Args>>::encode(payload, offset, args)), ...);
+
+            commit_record();
         }
     }
 }
@@ -46,13 +203,13 @@ namespace detail
 template<class... Args>
 void info(const Args&... args)
 {
-    detail::log_to(std::cout, args...);
+    detail::log<level::info>(args...);
 }
 
 template<class... Args>
 void error(const Args&... args)
 {
-    detail::log_to(std::cerr, args...);
+    detail::log<level::error>(args...);
 }
 
 } //namespace
@@ -21,22 +21,78 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBUTIL_MATRIX_HPP
 
 #include <array>
+#include <bitset>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
 
 namespace libutil
 {
 
-template<typename T, int Cols, int Rows>
+/*
+Layout policy of a matrix.
+
+ColumnMajor: whether the elements of a column are contiguous (otherwise, the
+elements of a row are).
+
+PaddingWidth: the contiguous dimension (the column in column-major order, the
+row in row-major order) is padded so that its size is a multiple of
+PaddingWidth, e.g. to match a SIMD register width. Padding elements are
+value-initialized and are not visited by for_each() and for_each_colrow().
+*/
+template<bool ColumnMajor, int PaddingWidth = 1>
+struct matrix_layout
+{
+    static_assert(PaddingWidth > 0);
+
+    static constexpr auto is_column_major = ColumnMajor;
+    static constexpr auto padding_width = PaddingWidth;
+
+    template<int Cols, int Rows>
+    struct for_size
+    {
+        static constexpr auto inner_size = ColumnMajor ? Rows : Cols;
+        static constexpr auto outer_size = ColumnMajor ? Cols : Rows;
+        static constexpr auto inner_padded_size = (inner_size + PaddingWidth - 1) / PaddingWidth * PaddingWidth;
+        static constexpr auto storage_size = inner_padded_size * outer_size;
+
+        //Distance, in number of elements, between two adjacent columns/rows
+        static constexpr auto col_stride = ColumnMajor ? inner_padded_size : 1;
+        static constexpr auto row_stride = ColumnMajor ? 1 : inner_padded_size;
+
+        static constexpr int get_index(const int col, const int row)
+        {
+            return col * col_stride + row * row_stride;
+        }
+    };
+};
+
+using column_major = matrix_layout<true>;
+using row_major = matrix_layout<false>;
+
+template<class Layout, int Width>
+using padded = matrix_layout<Layout::is_column_major, Width>;
+
+template<typename T, int Cols, int Rows, class Layout = column_major>
 struct matrix
 {
     static_assert(Cols > 0);
     static_assert(Rows > 0);
 
+    using value_type = T;
+    using layout = Layout;
+    using layout_impl = typename Layout::template for_size<Cols, Rows>;
+
     static constexpr auto cols = Cols;
     static constexpr auto rows = Rows;
     static constexpr auto size = Cols * Rows;
+    static constexpr auto storage_size = layout_impl::storage_size;
+    static constexpr auto col_stride = layout_impl::col_stride;
+    static constexpr auto row_stride = layout_impl::row_stride;
 
-    std::array<T, size> data;
+    std::array<T, storage_size> data;
 };
 
 struct matrix_coordinate
@@ -49,6 +105,7 @@ struct matrix_coordinate
 
 using matrix_coordinate_list = std::vector<matrix_coordinate>;
 
+//Iterate over the storage, padding included
 template<class Matrix>
 auto begin(Matrix& mat)
 {
@@ -61,10 +118,11 @@ auto end(Matrix& mat)
     return mat.data.end();
 }
 
+//Access element by storage index
 template<class Matrix>
 decltype(auto) at(Matrix& mat, const int i)
 {
-    assert(i < mat.size);
+    assert(i < mat.storage_size);
     return mat.data[i];
 }
 
@@ -72,7 +130,7 @@ template<class Matrix>
 decltype(auto) at(Matrix& mat, const int col, const int row)
 {
     assert(col < mat.cols && row < mat.rows);
-    return mat.data[col * mat.rows + row];
+    return mat.data[Matrix::layout_impl::get_index(col, row)];
 }
 
 template<class Matrix>
@@ -87,21 +145,255 @@ constexpr bool have_same_size()
     return Matrix::size == Matrix2::size;
 }
 
+template<class Matrix, class Matrix2>
+constexpr bool have_same_storage()
+{
+    return
+        std::is_same_v<typename Matrix::layout, typename Matrix2::layout> &&
+        Matrix::cols == Matrix2::cols &&
+        Matrix::rows == Matrix2::rows
+    ;
+}
+
+
+
+/*
+Views
+*/
+
+//View of elements separated by a constant distance, such as a row or a column
+//of a matrix
+template<class T>
+class strided_span
+{
+    public:
+        /*
+        Holds an index rather than a pointer, as one stride past the last
+        element can be past the end of the underlying array.
+        */
+        class iterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::remove_const_t<T>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = T*;
+                using reference = T&;
+
+                iterator() = default;
+
+                iterator(T* pfirst, const int index, const int stride):
+                    pfirst_(pfirst),
+                    index_(index),
+                    stride_(stride)
+                {
+                }
+
+                T& operator*() const
+                {
+                    return pfirst_[index_ * stride_];
+                }
+
+                T* operator->() const
+                {
+                    return &**this;
+                }
+
+                iterator& operator++()
+                {
+                    ++index_;
+                    return *this;
+                }
+
+                iterator operator++(int)
+                {
+                    auto tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+
+                bool operator==(const iterator& other) const
+                {
+                    return pfirst_ == other.pfirst_ && index_ == other.index_;
+                }
+
+            private:
+                T* pfirst_ = nullptr;
+                int index_ = 0;
+                int stride_ = 1;
+        };
+
+        strided_span(T* pfirst, const int size, const int stride):
+            pfirst_(pfirst),
+            size_(size),
+            stride_(stride)
+        {
+        }
+
+        int size() const
+        {
+            return size_;
+        }
+
+        T& operator[](const int i) const
+        {
+            assert(i < size_);
+            return pfirst_[i * stride_];
+        }
+
+        iterator begin() const
+        {
+            return iterator{pfirst_, 0, stride_};
+        }
+
+        iterator end() const
+        {
+            return iterator{pfirst_, size_, stride_};
+        }
+
+    private:
+        T* pfirst_;
+        int size_;
+        int stride_;
+};
+
+//View of a rectangular region of a matrix
+template<class T>
+class sub_matrix_view
+{
+    public:
+        sub_matrix_view
+        (
+            T* porigin,
+            const int cols,
+            const int rows,
+            const int col_stride,
+            const int row_stride
+        ):
+            porigin_(porigin),
+            cols_(cols),
+            rows_(rows),
+            col_stride_(col_stride),
+            row_stride_(row_stride)
+        {
+        }
+
+        int get_col_count() const
+        {
+            return cols_;
+        }
+
+        int get_row_count() const
+        {
+            return rows_;
+        }
+
+        T& at(const int col, const int row) const
+        {
+            assert(col < cols_ && row < rows_);
+            return porigin_[col * col_stride_ + row * row_stride_];
+        }
+
+        strided_span<T> get_col(const int col) const
+        {
+            return strided_span<T>{&at(col, 0), rows_, row_stride_};
+        }
+
+        strided_span<T> get_row(const int row) const
+        {
+            return strided_span<T>{&at(0, row), cols_, col_stride_};
+        }
+
+    private:
+        T* porigin_;
+        int cols_;
+        int rows_;
+        int col_stride_;
+        int row_stride_;
+};
+
+template<class Matrix>
+auto get_col(Matrix& mat, const int col)
+{
+    using value_t = std::remove_reference_t<decltype(mat.data[0])>;
+    return strided_span<value_t>{&at(mat, col, 0), mat.rows, mat.row_stride};
+}
+
+template<class Matrix>
+auto get_row(Matrix& mat, const int row)
+{
+    using value_t = std::remove_reference_t<decltype(mat.data[0])>;
+    return strided_span<value_t>{&at(mat, 0, row), mat.cols, mat.col_stride};
+}
+
+template<class Matrix>
+auto get_sub_matrix
+(
+    Matrix& mat,
+    const matrix_coordinate& origin,
+    const int cols,
+    const int rows
+)
+{
+    assert(origin.col + cols <= mat.cols && origin.row + rows <= mat.rows);
+    using value_t = std::remove_reference_t<decltype(mat.data[0])>;
+    return sub_matrix_view<value_t>
+    {
+        &at(mat, origin),
+        cols,
+        rows,
+        mat.col_stride,
+        mat.row_stride
+    };
+}
+
+
+
+/*
+Iteration
+*/
+
 //For each element matN_ji of each given matrix,
 //call f(mat0_ji, mat1_ji, ..., matN_ji).
+//Elements are visited in the storage order of the first matrix.
 template<typename F, class Matrix, class... Matrices>
 void for_each(F&& f, Matrix& mat, Matrices&... mats)
 {
-    static_assert((have_same_size<Matrix, Matrices>() && ...));
+    using matrix_t = std::remove_const_t<Matrix>;
+
+    static_assert((have_same_size<matrix_t, std::remove_const_t<Matrices>>() && ...));
 
-    for(auto i = 0; i < mat.size; ++i)
+    constexpr auto is_linear =
+        matrix_t::storage_size == matrix_t::size &&
+        (have_same_storage<matrix_t, std::remove_const_t<Matrices>>() && ...)
+    ;
+
+    if constexpr(is_linear)
+    {
+        //Contiguous storages of identical layout: plain loop, which the
+        //compiler can vectorize
+        for(auto i = 0; i < mat.size; ++i)
+        {
+            f(at(mat, i), at(mats, i)...);
+        }
+    }
+    else if constexpr(matrix_t::layout::is_column_major)
+    {
+        for(auto col = 0; col < mat.cols; ++col)
+            for(auto row = 0; row < mat.rows; ++row)
+                f(at(mat, col, row), at(mats, col, row)...);
+    }
+    else
     {
-        f(at(mat, i), at(mats, i)...);
+        for(auto row = 0; row < mat.rows; ++row)
+            for(auto col = 0; col < mat.cols; ++col)
+                f(at(mat, col, row), at(mats, col, row)...);
     }
 }
 
 //For each element matN_colrow of each given matrix,
 //call f(mat0_colrow, mat1_colrow, ..., matN_colrow, col, row).
+//Elements are always visited column by column, whatever the layout.
 template<typename F, class Matrix, class... Matrices>
 void for_each_colrow(F&& f, Matrix& mat, Matrices&... mats)
 {
@@ -120,6 +412,67 @@ void for_each_colrow(F&& f, Matrix& mat, Matrices&... mats)
     }
 }
 
+
+
+/*
+Bulk operations
+*/
+
+//Assign the given value to every element (padding included)
+template<class Matrix, class U>
+void fill(Matrix& mat, const U& value)
+{
+    mat.data.fill(value);
+}
+
+//Compare the elements (padding excluded) of two matrices of same size
+template<class Matrix, class Matrix2>
+bool equal(const Matrix& mat, const Matrix2& mat2)
+{
+    static_assert(Matrix::cols == Matrix2::cols && Matrix::rows == Matrix2::rows);
+
+    if constexpr(have_same_storage<Matrix, Matrix2>() && Matrix::storage_size == Matrix::size)
+    {
+        return mat.data == mat2.data;
+    }
+    else
+    {
+        auto same = true;
+        for_each
+        (
+            [&](const auto& l, const auto& r)
+            {
+                same = same && l == r;
+            },
+            mat,
+            mat2
+        );
+        return same;
+    }
+}
+
+/*
+Return a bit mask whose bit (col * rows + row) is set iff
+pred(at(mat, col, row)) is true.
+*/
+template<class Matrix, class Pred>
+std::bitset<Matrix::size> get_mask(const Matrix& mat, Pred&& pred)
+{
+    auto mask = std::bitset<Matrix::size>{};
+    for_each_colrow
+    (
+        [&](const auto& value, const int col, const int row)
+        {
+            if(pred(value))
+            {
+                mask.set(col * mat.rows + row);
+            }
+        },
+        mat
+    );
+    return mask;
+}
+
 } //namespace
 
 #endif
@@ -0,0 +1,217 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBUTIL_OBJECT_POOL_HPP
+#define LIBUTIL_OBJECT_POOL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace libutil
+{
+
+/*
+Pool of memory slots for objects of type T.
+
+Slots are allocated by chunks of ChunkSize, which are only freed when the pool
+is destroyed. Addresses are therefore stable, and freed slots are reused in
+O(1) through a free list.
+
+Not thread-safe.
+*/
+template<class T, std::size_t ChunkSize = 32>
+class object_pool
+{
+    private:
+        union slot
+        {
+            slot* pnext_free;
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+
+    public:
+        object_pool() = default;
+
+        object_pool(const object_pool&) = delete;
+
+        object_pool& operator=(const object_pool&) = delete;
+
+        //Return uninitialized memory for one T
+        void* allocate()
+        {
+            if(!pfree_)
+            {
+                add_chunk();
+            }
+
+            auto pslot = pfree_;
+            pfree_ = pslot->pnext_free;
+            ++allocated_count_;
+            return pslot->storage;
+        }
+
+        void deallocate(void* ptr)
+        {
+            assert(allocated_count_ > 0);
+            auto pslot = ::new(ptr) slot;
+            pslot->pnext_free = pfree_;
+            pfree_ = pslot;
+            --allocated_count_;
+        }
+
+        template<class... Args>
+        T* create(Args&&... args)
+        {
+            auto ptr = allocate();
+            try
+            {
+                return ::new(ptr) T(std::forward<Args>(args)...);
+            }
+            catch(...)
+            {
+                deallocate(ptr);
+                throw;
+            }
+        }
+
+        void destroy(T* ptr)
+        {
+            ptr->~T();
+            deallocate(ptr);
+        }
+
+        std::size_t get_allocated_count() const
+        {
+            return allocated_count_;
+        }
+
+        std::size_t get_capacity() const
+        {
+            return chunks_.size() * ChunkSize;
+        }
+
+    private:
+        void add_chunk()
+        {
+            auto& chunk = chunks_.emplace_back(std::make_unique<slot[]>(ChunkSize));
+
+            //Push the slots of the new chunk to the free list, so that they're
+            //allocated in address order
+            for(auto i = ChunkSize; i > 0; --i)
+            {
+                auto& s = chunk[i - 1];
+                s.pnext_free = pfree_;
+                pfree_ = &s;
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<slot[]>> chunks_;
+        slot* pfree_ = nullptr;
+        std::size_t allocated_count_ = 0;
+};
+
+//Return the pool shared by all the single-object allocations of type T
+template<class T>
+object_pool<T>& get_object_pool()
+{
+    static object_pool<T> pool;
+    return pool;
+}
+
+/*
+Standard allocator whose single-object allocations come from
+get_object_pool<T>().
+Array allocations go to the default allocator.
+*/
+template<class T>
+class pool_allocator
+{
+    public:
+        using value_type = T;
+
+        pool_allocator() = default;
+
+        template<class U>
+        pool_allocator(const pool_allocator<U>&)
+        {
+        }
+
+        T* allocate(const std::size_t n)
+        {
+            if(n == 1)
+            {
+                return static_cast<T*>(get_object_pool<T>().allocate());
+            }
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* ptr, const std::size_t n)
+        {
+            if(n == 1)
+            {
+                get_object_pool<T>().deallocate(ptr);
+                return;
+            }
+            std::allocator<T>{}.deallocate(ptr, n);
+        }
+
+        template<class U>
+        bool operator==(const pool_allocator<U>&) const
+        {
+            return true;
+        }
+};
+
+template<class T>
+struct pool_deleter
+{
+    void operator()(T* ptr) const
+    {
+        get_object_pool<T>().destroy(ptr);
+    }
+};
+
+template<class T>
+using pooled_unique_ptr = std::unique_ptr<T, pool_deleter<T>>;
+
+//Like std::make_unique(), with memory taken from get_object_pool<T>()
+template<class T, class... Args>
+pooled_unique_ptr<T> make_pooled_unique(Args&&... args)
+{
+    return pooled_unique_ptr<T>{get_object_pool<T>().create(std::forward<Args>(args)...)};
+}
+
+/*
+Like std::make_shared(), with memory (of both the object and the control
+block) taken from an object pool.
+*/
+template<class T, class... Args>
+std::shared_ptr<T> make_pooled_shared(Args&&... args)
+{
+    return std::allocate_shared<T>(pool_allocator<T>{}, std::forward<Args>(args)...);
+}
+
+} //namespace
+
+#endif
@@ -22,6 +22,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "tree.hpp"
 #include "matrix.hpp"
+#include <chrono>
 #include <variant>
 #include <vector>
 #include <list>
@@ -163,8 +164,8 @@ std::ostream& operator<<(std::ostream& l, const streamable<libutil::tree<T>>& r)
     return l << "{" << streamable{r.value.get_value()} << ", " << streamable{r.value.get_children()} << "}";
 }
 
-template<class T, int Cols, int Rows>
-std::ostream& operator<<(std::ostream& l, const streamable<libutil::matrix<T, Cols, Rows>>& r)
+template<class T, int Cols, int Rows, class Layout>
+std::ostream& operator<<(std::ostream& l, const streamable<libutil::matrix<T, Cols, Rows, Layout>>& r)
 {
     return l << streamable{r.value.data};
 }
@@ -21,11 +21,25 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBUTIL_TO_STRING_HPP
 
 #include <chrono>
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace libutil
 {
 
+//Large enough for any to_string() output
+constexpr auto to_string_buffer_size = 32;
+
+/*
+Allocation-free variants.
+They write into the given buffer and return a view on it.
+*/
+
+std::string_view to_string(int from, std::span<char> buffer);
+
+std::string_view to_string(const std::chrono::seconds& from, std::span<char> buffer);
+
 std::string to_string(int from);
 
 std::string to_string(const std::chrono::seconds& from);
@@ -20,52 +20,23 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBUTIL_UNIQUE_FUNCTION_HPP
 #define LIBUTIL_UNIQUE_FUNCTION_HPP
 
-#include <memory>
+#include "function_storage.hpp"
+#include <utility>
 
 namespace libutil
 {
 
 /*
 A variation of std::function that manages move-only function objects.
+Small function objects are stored in place (see detail::function_storage).
 */
 
-namespace detail
-{
-    template<class R, class... Args>
-    struct abstract_unique_function
-    {
-        virtual ~abstract_unique_function() = default;
-        virtual R operator()(Args...) = 0;
-    };
-
-    template<class F, class R, class... Args>
-    class concrete_unique_function: public abstract_unique_function<R, Args...>
-    {
-        public:
-            concrete_unique_function(F&& f):
-                f_(std::move(f))
-            {
-            }
-
-            R operator()(Args... args) override
-            {
-                return f_(std::forward<Args>(args)...);
-            }
-
-        private:
-            F f_;
-    };
-}
-
 template<class Signature>
 class unique_function;
 
 template<class R, class... Args>
 class unique_function<R(Args...)>
 {
-    private:
-        using fn_t = detail::abstract_unique_function<R, Args...>;
-
     public:
         unique_function() = default;
 
@@ -75,23 +46,17 @@ class unique_function<R(Args...)>
 
         template<class F>
         unique_function(F f):
-            pf_
-            (
-                std::make_unique<detail::concrete_unique_function<F, R, Args...>>
-                (
-                    std::move(f)
-                )
-            )
+            storage_(std::in_place, std::move(f))
         {
         }
 
         R operator()(Args... args)
         {
-            return (*pf_)(std::forward<Args>(args)...);
+            return storage_(std::forward<Args>(args)...);
         }
 
     private:
-        std::unique_ptr<fn_t> pf_;
+        detail::function_storage<R(Args...), false> storage_;
 };
 
 } //namespace
@@ -20,18 +20,21 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBUTIL_VOID_FUNCTION_HPP
 #define LIBUTIL_VOID_FUNCTION_HPP
 
-#include <chrono>
+#include "function_storage.hpp"
+#include <type_traits>
+#include <utility>
 
 namespace libutil
 {
 
 //Like std::function<void(Args...)>, but whose operator() doesn't throw if
 //default-constructed.
+//Small function objects are stored in place (see detail::function_storage).
 template<class... Args>
 class void_function
 {
     private:
-        using impl = std::function<void(Args...)>;
+        using impl = detail::function_storage<void(Args...), true>;
 
     public:
         void_function()
@@ -40,8 +43,10 @@ class void_function
 
         template<class F>
         void_function(F&& f):
-            impl_(f)
+            impl_(std::in_place, std::forward<F>(f))
         {
+            //Like std::function
+            static_assert(std::is_copy_constructible_v<std::decay_t<F>>, "void_function requires a copy-constructible function object");
         }
 
         void_function(const void_function& other):
@@ -59,16 +64,20 @@ class void_function
         {
         }
 
+        void_function& operator=(const void_function& other) = default;
+
+        void_function& operator=(void_function&& other) = default;
+
         void operator()(Args... args) const
         {
-            if(impl_)
+            if(!impl_.is_empty())
             {
                 impl_(std::forward<Args>(args)...);
             }
         }
 
     private:
-        impl impl_;
+        mutable impl impl_;
 };
 
 } //namespace
@@ -18,18 +18,248 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include <libutil/log.hpp>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <thread>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define LIBUTIL_LOG_HAS_CONSUMER_THREAD 0
+#else
+#define LIBUTIL_LOG_HAS_CONSUMER_THREAD 1
+#endif
 
 namespace libutil::log
 {
 
 namespace
 {
+    /*
+    Single-producer single-consumer ring buffer of variable-size records.
+    Every record starts with a header and is contiguous in memory. When a
+    record doesn't fit in the space left before the end of the buffer, a
+    padding record (with no writer) fills that space and the record is
+    written at the beginning of the buffer.
+    */
+    class ring_buffer
+    {
+        public:
+            static constexpr auto capacity = std::size_t{1} << 18; //256 KiB
+
+            ~ring_buffer()
+            {
+                stop();
+            }
+
+            void start()
+            {
+#if LIBUTIL_LOG_HAS_CONSUMER_THREAD
+                if(!consumer_thread_.joinable())
+                {
+                    consumer_thread_ = std::thread{[this]{consume_until_stopped();}};
+                }
+#endif
+            }
+
+            std::byte* begin_record
+            (
+                const level lvl,
+                const detail::record_writer_t writer,
+                const std::size_t payload_size
+            )
+            {
+                const auto record_size = detail::align_offset
+                (
+                    sizeof(record_header) + payload_size,
+                    sizeof(record_header)
+                );
+
+                auto head = head_.load(std::memory_order_relaxed);
+                const auto tail = tail_.load(std::memory_order_acquire);
+                const auto free_size = capacity - (head - tail);
+                const auto pos = head % capacity;
+                const auto contiguous_size = capacity - pos;
+                const auto padding_size = contiguous_size < record_size ? contiguous_size : 0;
+
+                if(padding_size + record_size > free_size)
+                {
+                    dropped_record_count_.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                if(padding_size != 0)
+                {
+                    ::new(buffer_ + pos) record_header
+                    {
+                        nullptr,
+                        level::none,
+                        static_cast<std::uint32_t>(padding_size)
+                    };
+                    head += padding_size;
+                }
+
+                auto pheader = ::new(buffer_ + head % capacity) record_header
+                {
+                    writer,
+                    lvl,
+                    static_cast<std::uint32_t>(record_size)
+                };
+
+                pending_head_ = head + record_size;
+
+                return reinterpret_cast<std::byte*>(pheader + 1);
+            }
+
+            void commit_record()
+            {
+                head_.store(pending_head_, std::memory_order_release);
+#if LIBUTIL_LOG_HAS_CONSUMER_THREAD
+                signal_.fetch_add(1, std::memory_order_release);
+                signal_.notify_one();
+#endif
+            }
+
+            void advance()
+            {
+#if LIBUTIL_LOG_HAS_CONSUMER_THREAD
+                if(consumer_thread_.joinable())
+                {
+                    return;
+                }
+#endif
+                consume();
+            }
+
+            void flush()
+            {
+#if LIBUTIL_LOG_HAS_CONSUMER_THREAD
+                if(consumer_thread_.joinable())
+                {
+                    //Wait for the consumer thread to catch up
+                    const auto head = head_.load(std::memory_order_relaxed);
+                    auto tail = tail_.load(std::memory_order_acquire);
+                    while(tail < head)
+                    {
+                        tail_.wait(tail, std::memory_order_acquire);
+                        tail = tail_.load(std::memory_order_acquire);
+                    }
+                    return;
+                }
+#endif
+                consume();
+            }
+
+        private:
+            struct alignas(std::max_align_t) record_header
+            {
+                detail::record_writer_t writer = nullptr; //nullptr for padding
+                level lvl = level::none;
+                std::uint32_t size = 0; //including header
+            };
+
+            static_assert(capacity % sizeof(record_header) == 0);
+
+            void stop()
+            {
+#if LIBUTIL_LOG_HAS_CONSUMER_THREAD
+                if(consumer_thread_.joinable())
+                {
+                    stopping_.store(true, std::memory_order_release);
+                    signal_.fetch_add(1, std::memory_order_release);
+                    signal_.notify_one();
+                    consumer_thread_.join();
+                    return;
+                }
+#endif
+                consume();
+            }
+
+#if LIBUTIL_LOG_HAS_CONSUMER_THREAD
+            void consume_until_stopped()
+            {
+                while(true)
+                {
+                    const auto signal = signal_.load(std::memory_order_acquire);
+
+                    consume();
+
+                    if(stopping_.load(std::memory_order_acquire))
+                    {
+                        consume();
+                        return;
+                    }
+
+                    signal_.wait(signal, std::memory_order_acquire);
+                }
+            }
+#endif
+
+            //Format and write all the committed records
+            void consume()
+            {
+                const auto head = head_.load(std::memory_order_acquire);
+                auto tail = tail_.load(std::memory_order_relaxed);
+
+                if(tail == head)
+                {
+                    return;
+                }
+
+                while(tail != head)
+                {
+                    auto pheader = std::launder(reinterpret_cast<record_header*>(buffer_ + tail % capacity));
+
+                    if(pheader->writer)
+                    {
+                        auto& os = pheader->lvl == level::error ? std::cerr : std::cout;
+                        pheader->writer(os, reinterpret_cast<std::byte*>(pheader + 1));
+                        os << '\n';
+                    }
+
+                    tail += pheader->size;
+                }
+
+                if(const auto count = dropped_record_count_.exchange(0, std::memory_order_relaxed); count != 0)
+                {
+                    std::cerr << "[log] " << count << " record(s) dropped (buffer full)\n";
+                }
+
+                std::cout.flush();
+                std::cerr.flush();
+
+                tail_.store(tail, std::memory_order_release);
+                tail_.notify_all();
+            }
+
+        private:
+            alignas(std::max_align_t) std::byte buffer_[capacity];
+
+            //Monotonic byte counters. Position in buffer is counter % capacity.
+            std::atomic<std::size_t> head_ = 0; //written by producer
+            std::atomic<std::size_t> tail_ = 0; //written by consumer
+            std::size_t pending_head_ = 0;
+
+            std::atomic<std::size_t> dropped_record_count_ = 0;
+
+#if LIBUTIL_LOG_HAS_CONSUMER_THREAD
+            std::atomic<std::uint32_t> signal_ = 0;
+            std::atomic<bool> stopping_ = false;
+            std::thread consumer_thread_;
+#endif
+    };
+
     bool enabled = false;
+
+    ring_buffer& get_ring_buffer()
+    {
+        static ring_buffer buf;
+        return buf;
+    }
 }
 
 void enable()
 {
+    get_ring_buffer().start();
     enabled = true;
 }
 
@@ -38,4 +268,38 @@ bool is_enabled()
     return enabled;
 }
 
+void advance()
+{
+    if(enabled)
+    {
+        get_ring_buffer().advance();
+    }
+}
+
+void flush()
+{
+    if(enabled)
+    {
+        get_ring_buffer().flush();
+    }
+}
+
+namespace detail
+{
+    std::byte* begin_record
+    (
+        const level lvl,
+        const record_writer_t writer,
+        const std::size_t payload_size
+    )
+    {
+        return get_ring_buffer().begin_record(lvl, writer, payload_size);
+    }
+
+    void commit_record()
+    {
+        get_ring_buffer().commit_record();
+    }
+}
+
 } //namespace
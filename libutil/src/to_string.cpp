@@ -18,35 +18,18 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include <libutil/to_string.hpp>
+#include <libutil/format.hpp>
+#include <array>
 
 namespace libutil
 {
 
-std::string to_string(int from)
+std::string_view to_string(const int from, const std::span<char> buffer)
 {
-    std::string str;
-    auto digit_index = 0;
-
-    do
-    {
-        const auto digit = from % 10;
-        const auto digit_char = static_cast<char>('0' + digit);
-
-        //add thousands separator
-        if(digit_index != 0 && digit_index % 3 == 0)
-            str = ' ' + str;
-
-        //add digit
-        str = std::string{digit_char} + str;
-
-        ++digit_index;
-        from /= 10;
-    } while(from != 0);
-
-    return str;
+    return format_to(buffer, "{:n}", from);
 }
 
-std::string to_string(const std::chrono::seconds& from)
+std::string_view to_string(const std::chrono::seconds& from, const std::span<char> buffer)
 {
     constexpr auto second = 1;
     constexpr auto minute = 60 * second;
@@ -61,32 +44,33 @@ std::string to_string(const std::chrono::seconds& from)
     const auto seconds = n;
 
     //Format string
-    auto str = std::string{};
+    if(hours != 0)
     {
-        if(hours != 0)
-        {
-            str += std::to_string(hours) + ":";
-        }
-
-        //Minutes
         if(minutes != 0)
         {
-            if(minutes < 10 && !str.empty())
-            {
-                str += "0";
-            }
-            str += std::to_string(minutes) + "'";
+            return format_to(buffer, "{}:{:02}'{:02}\"", hours, minutes, seconds);
         }
+        return format_to(buffer, "{}:{:02}\"", hours, seconds);
+    }
 
-        //Seconds
-        if(seconds < 10 && !str.empty())
-        {
-            str += "0";
-        }
-        str += std::to_string(n) + "\"";
+    if(minutes != 0)
+    {
+        return format_to(buffer, "{}'{:02}\"", minutes, seconds);
     }
 
-    return str;
+    return format_to(buffer, "{}\"", seconds);
+}
+
+std::string to_string(const int from)
+{
+    auto buffer = std::array<char, to_string_buffer_size>{};
+    return std::string{to_string(from, buffer)};
+}
+
+std::string to_string(const std::chrono::seconds& from)
+{
+    auto buffer = std::array<char, to_string_buffer_size>{};
+    return std::string{to_string(from, buffer)};
 }
 
 } //namespace
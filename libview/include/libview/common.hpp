@@ -22,6 +22,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "features/animable.hpp"
 #include "features/clickable.hpp"
+#include "features/drawable.hpp"
 #include "features/key_event_handler.hpp"
 #include <Magnum/SceneGraph/TranslationRotationScalingTransformation2D.h>
 #include <Magnum/SceneGraph/Object.h>
@@ -40,9 +41,9 @@ class object2d: public Magnum::SceneGraph::Object<transformation_t>
 {
     public:
         object2d(object2d* pparent = nullptr):
-            Magnum::SceneGraph::Object<transformation_t>(pparent),
-            pparent_(pparent)
+            Magnum::SceneGraph::Object<transformation_t>(pparent)
         {
+            mark_alpha_dirty();
         }
 
         virtual ~object2d() = default;
@@ -52,24 +53,106 @@ class object2d: public Magnum::SceneGraph::Object<transformation_t>
             return alpha_;
         }
 
+        /*
+        Return the product of the alpha of the object and of the alphas of all
+        its ancestors.
+        The value is cached. It's up to date after a call to
+        update_absolute_alphas() on the root of the tree, which the view does
+        before drawing each frame.
+        */
         float get_absolute_alpha() const
         {
-            if(pparent_)
+            return absolute_alpha_;
+        }
+
+        void set_alpha(const float value)
+        {
+            if(alpha_ != value)
             {
-                return alpha_ * pparent_->get_absolute_alpha();
+                alpha_ = value;
+                mark_alpha_dirty();
             }
+        }
 
-            return alpha_;
+        //Hide the Magnum functions, so that reparented objects get the alpha
+        //of their new parent
+        object2d& setParent(object2d* pparent)
+        {
+            Magnum::SceneGraph::Object<transformation_t>::setParent(pparent);
+            mark_alpha_dirty();
+            return *this;
         }
 
-        void set_alpha(const float value)
+        object2d& setParentKeepTransformation(object2d* pparent)
+        {
+            Magnum::SceneGraph::Object<transformation_t>::setParentKeepTransformation(pparent);
+            mark_alpha_dirty();
+            return *this;
+        }
+
+        /*
+        Update the absolute alpha of the objects of the tree whose alpha (or
+        the alpha of an ancestor) changed since the last call.
+        Must be called on the root of the tree. Only the branches that lead to
+        a changed object are visited.
+        */
+        void update_absolute_alphas()
         {
-            alpha_ = value;
+            update_absolute_alphas(1.0f, false);
+        }
+
+    private:
+        object2d* get_parent()
+        {
+            //All the objects of the tree are object2d
+            return static_cast<object2d*>(parent());
+        }
+
+        void mark_alpha_dirty()
+        {
+            alpha_dirty_ = true;
+
+            //Make the path from the root to this object visible to
+            //update_absolute_alphas()
+            for
+            (
+                auto pobj = get_parent();
+                pobj && !pobj->has_dirty_descendant_;
+                pobj = pobj->get_parent()
+            )
+            {
+                pobj->has_dirty_descendant_ = true;
+            }
+        }
+
+        void update_absolute_alphas(const float parent_absolute_alpha, const bool parent_changed)
+        {
+            const auto changed = parent_changed || alpha_dirty_;
+
+            if(!changed && !has_dirty_descendant_)
+            {
+                return;
+            }
+
+            if(changed)
+            {
+                absolute_alpha_ = alpha_ * parent_absolute_alpha;
+            }
+
+            for(auto pchild = children().first(); pchild; pchild = pchild->nextSibling())
+            {
+                static_cast<object2d*>(pchild)->update_absolute_alphas(absolute_alpha_, changed);
+            }
+
+            alpha_dirty_ = false;
+            has_dirty_descendant_ = false;
         }
 
     private:
-        object2d* pparent_ = nullptr;
         float alpha_ = 1.0f;
+        float absolute_alpha_ = 1.0f;
+        bool alpha_dirty_ = false;
+        bool has_dirty_descendant_ = false;
 };
 
 class scene: public object2d
@@ -84,12 +167,6 @@ class scene: public object2d
         }
 };
 
-namespace features
-{
-    using drawable = Magnum::SceneGraph::Drawable2D;
-    using drawable_group = Magnum::SceneGraph::DrawableGroup2D;
-}
-
 struct feature_group_set
 {
     features::drawable_group drawables;
@@ -32,6 +32,14 @@ class animable: public Magnum::SceneGraph::AbstractGroupedFeature2D<animable>
         using Magnum::SceneGraph::AbstractGroupedFeature2D<animable>::AbstractGroupedFeature2D;
 
         virtual void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s) = 0;
+
+        /*
+        Return whether advance() changes what is drawn (e.g. because of a
+        running animation).
+        The view doesn't redraw the scene when no animable is animating (unless
+        something else changed).
+        */
+        virtual bool is_animating() const = 0;
 };
 
 using animable_group = Magnum::SceneGraph::FeatureGroup2D<animable>;
@@ -21,6 +21,11 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBVIEW_FEATURES_CLICKABLE_HPP
 
 #include <Magnum/SceneGraph/AbstractGroupedFeature.h>
+#include <Magnum/SceneGraph/FeatureGroup.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Magnum.h>
+#include <optional>
 
 namespace libview::features
 {
@@ -28,7 +33,67 @@ namespace libview::features
 class clickable: public Magnum::SceneGraph::AbstractGroupedFeature2D<clickable>
 {
     public:
-        using Magnum::SceneGraph::AbstractGroupedFeature2D<clickable>::AbstractGroupedFeature2D;
+        clickable
+        (
+            Magnum::SceneGraph::AbstractObject2D& obj,
+            Magnum::SceneGraph::FeatureGroup2D<clickable>* pgroup = nullptr
+        ):
+            Magnum::SceneGraph::AbstractGroupedFeature2D<clickable>(obj, pgroup)
+        {
+            setCachedTransformations
+            (
+                Magnum::SceneGraph::CachedTransformation::Absolute |
+                Magnum::SceneGraph::CachedTransformation::InvertedAbsolute
+            );
+
+            //Make sure clean() is called at the next setClean()
+            obj.setDirty();
+
+            ++revision_;
+        }
+
+        ~clickable()
+        {
+            ++revision_;
+        }
+
+        /*
+        Return a number that changes whenever a clickable is created, destroyed
+        or moved, so that the view knows when its hit-test index is stale.
+        */
+        static unsigned int get_revision()
+        {
+            return revision_;
+        }
+
+        /*
+        Return the bounds of the area where do_is_inside() can return true, in
+        the coordinate system of the object.
+        A clickable without bounds is tested against every mouse event.
+        */
+        virtual std::optional<Magnum::Range2D> get_bounds() const
+        {
+            return std::nullopt;
+        }
+
+        /*
+        Absolute transformation matrix and its inverse, as of the last call to
+        object().setClean().
+        */
+        const Magnum::Matrix3& get_absolute_transformation_matrix() const
+        {
+            return absolute_transformation_matrix_;
+        }
+
+        const Magnum::Matrix3& get_inverted_absolute_transformation_matrix() const
+        {
+            return inverted_absolute_transformation_matrix_;
+        }
+
+        bool is_inside() const
+        {
+            return is_inside_;
+        }
 
         void handle_mouse_move(const Magnum::Vector2& model_space_position)
         {
@@ -93,7 +158,28 @@ class clickable: public Magnum::SceneGraph::AbstractGroupedFeature2D<clickable>
 
         virtual void do_handle_mouse_click(){}
 
+    //Magnum::SceneGraph::AbstractFeature2D virtual functions
+    private:
+        void markDirty() override
+        {
+            ++revision_;
+        }
+
+        void clean(const Magnum::Matrix3& absolute_transformation_matrix) override
+        {
+            absolute_transformation_matrix_ = absolute_transformation_matrix;
+        }
+
+        void cleanInverted(const Magnum::Matrix3& inverted_absolute_transformation_matrix) override
+        {
+            inverted_absolute_transformation_matrix_ = inverted_absolute_transformation_matrix;
+        }
+
     private:
+        static inline unsigned int revision_ = 0;
+
+        Magnum::Matrix3 absolute_transformation_matrix_;
+        Magnum::Matrix3 inverted_absolute_transformation_matrix_;
         bool is_inside_ = false;
         bool pressed_ = false;
 };
@@ -0,0 +1,70 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBVIEW_FEATURES_DRAWABLE_HPP
+#define LIBVIEW_FEATURES_DRAWABLE_HPP
+
+#include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Magnum.h>
+#include <optional>
+
+namespace libview::features
+{
+
+/*
+Drawable that also tells which GL state it uses and where it draws, so that
+the view can reorder the drawables to minimize the state changes.
+*/
+class drawable: public Magnum::SceneGraph::Drawable2D
+{
+    public:
+        //Shader and texture used by draw(), identified by their address
+        struct state
+        {
+            const void* pshader = nullptr; //nullptr if unknown
+            const void* ptexture = nullptr; //nullptr if none
+
+            bool operator==(const state&) const = default;
+        };
+
+    public:
+        using Magnum::SceneGraph::Drawable2D::Drawable2D;
+
+        virtual state get_state() const
+        {
+            return {};
+        }
+
+        /*
+        Return the bounds of what draw() draws, in the coordinate system of the
+        object.
+        A drawable without bounds is assumed to overlap every other drawable.
+        */
+        virtual std::optional<Magnum::Range2D> get_bounds() const
+        {
+            return std::nullopt;
+        }
+};
+
+using drawable_group = Magnum::SceneGraph::DrawableGroup2D;
+
+} //namespace
+
+#endif
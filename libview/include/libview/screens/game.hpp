@@ -58,6 +58,8 @@ class game: public object2d, public features::animable, public features::key_eve
     private:
         void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s) override;
 
+        bool is_animating() const override;
+
     //key_event_handler overrides
     private:
         void handle_key_press(key_event& event) override;
@@ -107,6 +107,13 @@ class view
             float elapsed_s
         );
 
+        /*
+        Return whether the scene changed since the last call to draw(), or is
+        being animated.
+        When it returns false, calling draw() would draw the same frame again.
+        */
+        bool needs_redraw() const;
+
         void draw();
 
         void set_viewport(const Magnum::Vector2i& size);
@@ -18,30 +18,216 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "animation.hpp"
+#include <Magnum/Animation/Easing.h>
+#include <Magnum/Math/Functions.h>
+#include <algorithm>
 
 namespace libview::animation
 {
 
-#define INTERPOLATOR(FUNCTION_NAME, TYPE, EASING) \
-    const interpolator_t<TYPE>& FUNCTION_NAME() \
-    { \
-        static const auto interpolator = interpolator_t<TYPE> \
-        { \
-            Magnum::Animation::ease \
-            < \
-                TYPE, \
-                Magnum::Math::lerp, \
-                Magnum::Animation::Easing::EASING \
-            >() \
-        }; \
-        return interpolator; \
+namespace
+{
+    float ease(const easing easing_id, const float t)
+    {
+        using easings = Magnum::Animation::Easing;
+
+        switch(easing_id)
+        {
+            case easing::linear:          return t;
+            case easing::exponential_in:  return easings::exponentialIn(t);
+            case easing::exponential_out: return easings::exponentialOut(t);
+            case easing::cubic_out:       return easings::cubicOut(t);
+            case easing::back_out:        return easings::backOut(t);
+        }
+        return t;
+    }
+}
+
+void animation::add(tracks::closure&& track)
+{
+    closures_.push_back(std::move(track.f));
+}
+
+void animation::add(const tracks::pause& track)
+{
+    duration_s_ = std::max(duration_s_, track.duration_s);
+}
+
+void animation::add(const tracks::fixed_duration_translation& track)
+{
+    add_tween
+    (
+        track.pobj,
+        tween
+        {
+            .prop = property::translation,
+            .easing_id = track.easing_id,
+            .finish_value = track.finish_position,
+            .duration_s = track.duration_s
+        }
+    );
+}
+
+void animation::add(const tracks::fixed_speed_translation& track)
+{
+    add_tween
+    (
+        track.pobj,
+        tween
+        {
+            .prop = property::translation,
+            .easing_id = track.easing_id,
+            .finish_value = track.finish_position,
+            .speed = track.speed
+        }
+    );
+}
+
+void animation::add(const tracks::alpha_transition& track)
+{
+    add_tween
+    (
+        track.pobj,
+        tween
+        {
+            .prop = property::alpha,
+            .easing_id = track.easing_id,
+            .finish_value = {track.finish_alpha, 0.0f},
+            .duration_s = track.duration_s
+        }
+    );
+}
+
+void animation::add(const tracks::scaling_transition& track)
+{
+    add_tween
+    (
+        track.pobj,
+        tween
+        {
+            .prop = property::scaling,
+            .easing_id = track.easing_id,
+            .finish_value = track.finish_scaling,
+            .duration_s = track.duration_s
+        }
+    );
+}
+
+void animation::advance(const std::chrono::steady_clock::time_point& now)
+{
+    if(paused_ || done_)
+    {
+        return;
+    }
+
+    if(!started_)
+    {
+        start(now);
+    }
+
+    const auto elapsed_s = std::chrono::duration<float>{now - start_time_}.count();
+
+    for(const auto& t: tweens_)
+    {
+        const auto progress = t.duration_s > 0 ?
+            std::min(elapsed_s / t.duration_s, 1.0f) :
+            1.0f
+        ;
+        const auto value = Magnum::Math::lerp
+        (
+            t.start_value,
+            t.finish_value,
+            ease(t.easing_id, progress)
+        );
+
+        switch(t.prop)
+        {
+            case property::translation:
+                t.ptarget->setTranslation(value);
+                break;
+            case property::scaling:
+                t.ptarget->setScaling(value);
+                break;
+            case property::alpha:
+                t.ptarget->set_alpha(value.x());
+                break;
+        }
+    }
+
+    done_ = elapsed_s >= duration_s_;
+}
+
+void animation::pause()
+{
+    if(!paused_)
+    {
+        pause_time_ = std::chrono::steady_clock::now();
+        paused_ = true;
+    }
+}
+
+void animation::resume()
+{
+    if(paused_)
+    {
+        //Don't count the time spent paused
+        start_time_ += std::chrono::steady_clock::now() - pause_time_;
+        paused_ = false;
     }
+}
 
-INTERPOLATOR(get_exponential_in_float_interpolator, float, exponentialIn)
-INTERPOLATOR(get_exponential_out_float_interpolator, float, exponentialOut)
-INTERPOLATOR(get_cubic_out_vector2_interpolator, Magnum::Vector2, cubicOut)
-INTERPOLATOR(get_back_out_vector2_interpolator, Magnum::Vector2, backOut)
+void animation::add_tween(const std::shared_ptr<object2d>& pobj, const tween& t)
+{
+    tweens_.push_back(t);
+    tweens_.back().ptarget = pobj.get();
+    ptargets_.push_back(pobj);
+}
+
+void animation::start(const std::chrono::steady_clock::time_point& now)
+{
+    for(auto& f: closures_)
+    {
+        f();
+    }
+
+    for(auto& t: tweens_)
+    {
+        switch(t.prop)
+        {
+            case property::translation:
+                t.start_value = t.ptarget->transformation().translation();
+                break;
+            case property::scaling:
+                t.start_value = t.ptarget->transformation().scaling();
+                break;
+            case property::alpha:
+                t.start_value = {t.ptarget->get_alpha(), 0.0f};
+                break;
+        }
+    }
+
+    //Drop the translations and scalings that have nothing to do
+    std::erase_if
+    (
+        tweens_,
+        [](const tween& t)
+        {
+            return t.prop != property::alpha && t.start_value == t.finish_value;
+        }
+    );
+
+    for(auto& t: tweens_)
+    {
+        if(t.speed != 0)
+        {
+            t.duration_s = (t.finish_value - t.start_value).length() / t.speed;
+        }
+
+        duration_s_ = std::max(duration_s_, t.duration_s);
+    }
 
-#undef INTERPOLATOR
+    start_time_ = now;
+    started_ = true;
+}
 
 } //namespace
@@ -23,321 +23,77 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include "common.hpp"
 #include <libutil/unique_function.hpp>
 #include <chrono>
-#include <Magnum/Animation/Easing.h>
-#include <Magnum/Animation/Player.h>
-#include <Magnum/Animation/Track.h>
-#include <chrono>
-#include <list>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <vector>
 
 namespace libview::animation
 {
 
-using player_t = Magnum::Animation::Player<std::chrono::nanoseconds, Magnum::Float>;
-using player_supplier_t = libutil::unique_function<void(player_t&)>;
-
-template<class ValueType, class ResultType = Magnum::Animation::ResultOf<ValueType>>
-using interpolator_t = ResultType(*)(const ValueType&, const ValueType&, Magnum::Float);
-
-const interpolator_t<float>& get_exponential_in_float_interpolator();
-const interpolator_t<float>& get_exponential_out_float_interpolator();
-const interpolator_t<Magnum::Vector2>& get_back_out_vector2_interpolator();
-const interpolator_t<Magnum::Vector2>& get_cubic_out_vector2_interpolator();
+enum class easing: std::uint8_t
+{
+    linear,
+    exponential_in,
+    exponential_out,
+    cubic_out,
+    back_out
+};
 
 namespace tracks
 {
-    //Arbitrary code
+    //Arbitrary code, called once when the animation starts
     struct closure
     {
         libutil::unique_function<void()> f;
     };
 
-    inline
-    player_supplier_t make_player_supplier(closure&& track)
-    {
-        using track_impl_t = Magnum::Animation::Track<Magnum::Float, int>;
-        return [track = std::move(track), track_impl = track_impl_t{}](player_t& player) mutable
-        {
-            track_impl = track_impl_t
-            (
-                {
-                    {0.0f, 0},
-                },
-                Magnum::Math::lerp,
-                Magnum::Animation::Extrapolation::Constant
-            );
-
-            player.addWithCallback
-            (
-                track_impl,
-                [](Magnum::Float, const int&, closure& t)
-                {
-                    t.f();
-                },
-                track
-            );
-        };
-    }
-
-
-
     struct pause
     {
         float duration_s = 0;
     };
 
-    inline
-    player_supplier_t make_player_supplier(const pause& track)
-    {
-        using track_impl_t = Magnum::Animation::Track<Magnum::Float, int>;
-        return [track, track_impl = track_impl_t{}](player_t& player) mutable
-        {
-            track_impl = track_impl_t
-            (
-                {
-                    {0.0f, 0},
-                    {track.duration_s, 0}
-                },
-                Magnum::Math::lerp,
-                Magnum::Animation::Extrapolation::Constant
-            );
-
-            player.addWithCallback
-            (
-                track_impl,
-                [](Magnum::Float, const int&, void*){},
-                nullptr
-            );
-        };
-    }
-
-
-
     struct fixed_duration_translation
     {
         std::shared_ptr<object2d> pobj;
         Magnum::Vector2 finish_position;
         float duration_s = 0; //in seconds
-        Magnum::Animation::Track<Magnum::Float, Magnum::Vector2>::Interpolator interpolator = Magnum::Math::lerp;
+        easing easing_id = easing::linear;
     };
 
-    inline
-    player_supplier_t make_player_supplier(const fixed_duration_translation& track)
-    {
-        using track_impl_t = Magnum::Animation::Track<Magnum::Float, Magnum::Vector2>;
-        return [track, track_impl = track_impl_t{}](player_t& player) mutable
-        {
-            const auto& current_position = track.pobj->transformation().translation();
-
-            if(current_position == track.finish_position)
-            {
-                return;
-            }
-
-            if(track.duration_s == 0)
-            {
-                track_impl = track_impl_t
-                {
-                    {
-                        {0.0f, track.finish_position},
-                    },
-                    Magnum::Math::lerp,
-                    Magnum::Animation::Extrapolation::Constant
-                };
-            }
-            else
-            {
-                track_impl = track_impl_t
-                {
-                    {
-                        {0.0f, current_position},
-                        {track.duration_s, track.finish_position}
-                    },
-                    track.interpolator,
-                    Magnum::Animation::Extrapolation::Constant
-                };
-            }
-
-            player.addWithCallback
-            (
-                track_impl,
-                [](Magnum::Float, const Magnum::Vector2& translation, object2d& obj)
-                {
-                    obj.setTranslation(translation);
-                },
-                *track.pobj
-            );
-        };
-    }
-
-
-
     struct fixed_speed_translation
     {
         std::shared_ptr<object2d> pobj;
         Magnum::Vector2 finish_position;
         float speed = 0; //in distance unit per second
-        Magnum::Animation::Track<Magnum::Float, Magnum::Vector2>::Interpolator interpolator = Magnum::Math::lerp;
+        easing easing_id = easing::linear;
     };
 
-    inline
-    player_supplier_t make_player_supplier(const fixed_speed_translation& track)
-    {
-        using track_impl_t = Magnum::Animation::Track<Magnum::Float, Magnum::Vector2>;
-        return [track, track_impl = track_impl_t{}](player_t& player) mutable
-        {
-            const auto& current_position = track.pobj->transformation().translation();
-
-            if(current_position == track.finish_position)
-            {
-                return;
-            }
-
-            const auto x1 = current_position.x();
-            const auto y1 = current_position.y();
-            const auto x2 = track.finish_position.x();
-            const auto y2 = track.finish_position.y();
-            const auto distance = std::sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
-            const auto time = distance / track.speed;
-
-            track_impl = track_impl_t
-            {
-                {
-                    {0.0f, current_position},
-                    {time, track.finish_position}
-                },
-                track.interpolator,
-                Magnum::Animation::Extrapolation::Constant
-            };
-
-            player.addWithCallback
-            (
-                track_impl,
-                [](Magnum::Float, const Magnum::Vector2& translation, object2d& obj)
-                {
-                    obj.setTranslation(translation);
-                },
-                *track.pobj
-            );
-        };
-    }
-
-
-
     struct alpha_transition
     {
         std::shared_ptr<object2d> pobj;
         float finish_alpha = 0;
         float duration_s = 0; //in seconds
-        Magnum::Animation::Track<Magnum::Float, float>::Interpolator interpolator = Magnum::Math::lerp;
+        easing easing_id = easing::linear;
     };
 
-    inline
-    player_supplier_t make_player_supplier(const alpha_transition& track)
-    {
-        using track_impl_t = Magnum::Animation::Track<Magnum::Float, float>;
-        return [track, track_impl = track_impl_t{}](player_t& player) mutable
-        {
-            const auto current_alpha = track.pobj->get_alpha();
-
-            if(track.duration_s == 0)
-            {
-                track_impl = track_impl_t
-                {
-                    {
-                        {0.0f, track.finish_alpha},
-                    },
-                    Magnum::Math::lerp,
-                    Magnum::Animation::Extrapolation::Constant
-                };
-            }
-            else
-            {
-                track_impl = track_impl_t
-                {
-                    {
-                        {0.0f, current_alpha},
-                        {track.duration_s, track.finish_alpha}
-                    },
-                    track.interpolator,
-                    Magnum::Animation::Extrapolation::Constant
-                };
-            }
-
-            player.addWithCallback
-            (
-                track_impl,
-                [](Magnum::Float, const float& alpha, object2d& obj)
-                {
-                    obj.set_alpha(alpha);
-                },
-                *track.pobj
-            );
-        };
-    }
-
-
-
     struct scaling_transition
     {
         std::shared_ptr<object2d> pobj;
         Magnum::Vector2 finish_scaling;
         float duration_s = 0; //in seconds
-        Magnum::Animation::Track<Magnum::Float, Magnum::Vector2>::Interpolator interpolator = Magnum::Math::lerp;
+        easing easing_id = easing::linear;
     };
-
-    inline
-    player_supplier_t make_player_supplier(const scaling_transition& track)
-    {
-        using track_impl_t = Magnum::Animation::Track<Magnum::Float, Magnum::Vector2>;
-
-        return [track, track_impl = track_impl_t{}](player_t& player) mutable
-        {
-            const auto current_scaling = track.pobj->transformation().scaling();
-
-            if(current_scaling == track.finish_scaling)
-            {
-                return;
-            }
-
-            if(track.duration_s == 0)
-            {
-                track_impl = track_impl_t
-                {
-                    {
-                        {0.0f, track.finish_scaling}
-                    },
-                    Magnum::Math::lerp,
-                    Magnum::Animation::Extrapolation::Constant
-                };
-            }
-            else
-            {
-                track_impl = track_impl_t
-                {
-                    {
-                        {0.0f, current_scaling},
-                        {track.duration_s, track.finish_scaling}
-                    },
-                    track.interpolator,
-                    Magnum::Animation::Extrapolation::Constant
-                };
-            }
-
-            player.addWithCallback
-            (
-                track_impl,
-                [](Magnum::Float, const Magnum::Vector2& scaling, object2d& obj)
-                {
-                    obj.setScaling(scaling);
-                },
-                *track.pobj
-            );
-        };
-    }
 }
 
-//An animation is made of several tracks. Tracks are played concurrently.
+/*
+An animation is made of several tracks. Tracks are played concurrently.
+
+The interpolated tracks are stored as plain tweens in a contiguous array, so
+that advancing an animation of hundreds of tracks is a single loop.
+The start value of a tween is the value of its target when the animation
+starts.
+*/
 class animation
 {
     public:
@@ -359,49 +115,66 @@ class animation
             add(std::forward<Track>(track));
         }
 
-        template<class Track>
-        void add(Track&& track)
-        {
-            player_suppliers_.push_back(make_player_supplier(std::forward<Track>(track)));
-        }
+        void add(tracks::closure&& track);
 
-        void advance(const std::chrono::steady_clock::time_point& now)
-        {
-            if(!started_)
-            {
-                //Supply player with tracks
-                for(auto& player_supplier: player_suppliers_)
-                {
-                    player_supplier(player_);
-                }
+        void add(const tracks::pause& track);
 
-                player_.play(now.time_since_epoch());
+        void add(const tracks::fixed_duration_translation& track);
 
-                started_ = true;
-            }
+        void add(const tracks::fixed_speed_translation& track);
 
-            player_.advance(now.time_since_epoch());
-        }
+        void add(const tracks::alpha_transition& track);
 
-        void pause()
+        void add(const tracks::scaling_transition& track);
+
+        void advance(const std::chrono::steady_clock::time_point& now);
+
+        void pause();
+
+        void resume();
+
+        bool is_done() const
         {
-            player_.pause(std::chrono::steady_clock::now().time_since_epoch());
+            return done_;
         }
 
-        void resume()
+    private:
+        enum class property: std::uint8_t
         {
-            player_.resume(std::chrono::steady_clock::now().time_since_epoch());
-        }
+            translation,
+            scaling,
+            alpha //stored in x
+        };
 
-        bool is_done() const
+        struct tween
         {
-            return started_ && player_.state() == Magnum::Animation::State::Stopped;
-        }
+            object2d* ptarget = nullptr;
+            property prop = property::translation;
+            easing easing_id = easing::linear;
+            Magnum::Vector2 start_value; //set when the animation starts
+            Magnum::Vector2 finish_value;
+            float duration_s = 0; //computed when the animation starts if speed != 0
+            float speed = 0;
+        };
 
     private:
-        std::vector<player_supplier_t> player_suppliers_;
-        player_t player_;
+        void add_tween(const std::shared_ptr<object2d>& pobj, const tween& t);
+
+        void start(const std::chrono::steady_clock::time_point& now);
+
+    private:
+        std::vector<tween> tweens_;
+        std::vector<libutil::unique_function<void()>> closures_;
+
+        //Keep the targets of the tweens alive
+        std::vector<std::shared_ptr<object2d>> ptargets_;
+
+        float duration_s_ = 0;
+        std::chrono::steady_clock::time_point start_time_;
+        std::chrono::steady_clock::time_point pause_time_;
         bool started_ = false;
+        bool paused_ = false;
+        bool done_ = false;
 };
 
 //An animator manages a queue of animations. Pushed animations are played
@@ -461,7 +234,7 @@ class animator
         }
 
     private:
-        std::list<animation> animations_;
+        std::deque<animation> animations_;
 };
 
 } //namespace
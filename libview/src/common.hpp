@@ -28,12 +28,49 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <Magnum/SceneGraph/Object.h>
 #include <Magnum/SceneGraph/Scene.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Range.h>
+#include <array>
 
 namespace libview
 {
 
 using namespace Magnum::Math::Literals;
 
+/*
+Notify the view that the scene must be redrawn.
+Only needed for changes that are caused neither by an input event nor by an
+animable (e.g. a label whose text is set by the application).
+*/
+void request_redraw();
+
+//Return the axis-aligned bounding box of the transformed given range
+inline Magnum::Range2D transform_range
+(
+    const Magnum::Range2D& range,
+    const Magnum::Matrix3& transformation_matrix
+)
+{
+    const auto corners = std::array<Magnum::Vector2, 4>
+    {
+        transformation_matrix.transformPoint(range.bottomLeft()),
+        transformation_matrix.transformPoint(range.bottomRight()),
+        transformation_matrix.transformPoint(range.topLeft()),
+        transformation_matrix.transformPoint(range.topRight())
+    };
+
+    auto min = corners[0];
+    auto max = corners[0];
+    for(const auto& corner: corners)
+    {
+        min = Magnum::Math::min(min, corner);
+        max = Magnum::Math::max(max, corner);
+    }
+
+    return Magnum::Range2D{min, max};
+}
+
 } //namespace
 
 #endif
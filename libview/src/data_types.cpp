@@ -37,7 +37,7 @@ std::string_view get_pretty_name(const stage s)
     return "";
 }
 
-std::optional<std::filesystem::path> get_image(const stage s)
+std::optional<libres::images::image> get_image(const stage s)
 {
     switch(s)
     {
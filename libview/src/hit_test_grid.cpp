@@ -0,0 +1,188 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "hit_test_grid.hpp"
+#include "common.hpp"
+#include <Magnum/Math/Functions.h>
+#include <algorithm>
+
+namespace libview
+{
+
+namespace
+{
+    //Unlike Magnum::Range2D::contains(), include the max edges
+    bool contains(const Magnum::Range2D& range, const Magnum::Vector2& point)
+    {
+        return
+            range.min().x() <= point.x() && point.x() <= range.max().x() &&
+            range.min().y() <= point.y() && point.y() <= range.max().y()
+        ;
+    }
+}
+
+const std::vector<features::clickable*>& hit_test_grid::get_candidates
+(
+    features::clickable_group& clickables,
+    const Magnum::Vector2& world_space_position
+)
+{
+    if(!built_ || revision_ != features::clickable::get_revision())
+    {
+        rebuild(clickables);
+
+        //The indices of the previous candidates may be invalid
+        candidate_indices_.clear();
+        for(std::size_t i = 0; i < pclickables_.size(); ++i)
+        {
+            if(pclickables_[i]->is_inside())
+            {
+                candidate_indices_.push_back(i);
+            }
+        }
+    }
+    else
+    {
+        //Keep the previous candidates the pointer was inside of
+        std::erase_if
+        (
+            candidate_indices_,
+            [&](const std::size_t i)
+            {
+                return !pclickables_[i]->is_inside();
+            }
+        );
+    }
+
+    candidate_indices_.insert
+    (
+        candidate_indices_.end(),
+        unbounded_indices_.begin(),
+        unbounded_indices_.end()
+    );
+
+    if(bounds_ && contains(*bounds_, world_space_position))
+    {
+        const auto cell = get_cell(world_space_position);
+        const auto& cell_indices = cells_[cell.y() * cell_count_per_axis + cell.x()];
+
+        for(const auto i: cell_indices)
+        {
+            if(contains(*world_space_bounds_[i], world_space_position))
+            {
+                candidate_indices_.push_back(i);
+            }
+        }
+    }
+
+    std::sort(candidate_indices_.begin(), candidate_indices_.end());
+    candidate_indices_.erase
+    (
+        std::unique(candidate_indices_.begin(), candidate_indices_.end()),
+        candidate_indices_.end()
+    );
+
+    pcandidates_.clear();
+    for(const auto i: candidate_indices_)
+    {
+        pcandidates_.push_back(pclickables_[i]);
+    }
+
+    return pcandidates_;
+}
+
+void hit_test_grid::rebuild(features::clickable_group& clickables)
+{
+    pclickables_.clear();
+    world_space_bounds_.clear();
+    unbounded_indices_.clear();
+    bounds_ = std::nullopt;
+
+    for(std::size_t i = 0; i < clickables.size(); ++i)
+    {
+        auto& clickable = clickables[i];
+
+        //Compute the cached transformations of the clickable
+        clickable.object().setClean();
+
+        pclickables_.push_back(&clickable);
+
+        const auto opt_bounds = clickable.get_bounds();
+        if(!opt_bounds)
+        {
+            world_space_bounds_.push_back(std::nullopt);
+            unbounded_indices_.push_back(i);
+            continue;
+        }
+
+        const auto bounds = transform_range(*opt_bounds, clickable.get_absolute_transformation_matrix());
+        world_space_bounds_.push_back(bounds);
+        bounds_ = bounds_ ? Magnum::Math::join(*bounds_, bounds) : bounds;
+    }
+
+    cells_.resize(cell_count_per_axis * cell_count_per_axis);
+    for(auto& cell: cells_)
+    {
+        cell.clear();
+    }
+
+    if(bounds_)
+    {
+        //Avoid divisions by zero if all the bounds are degenerate
+        cell_size_ = Magnum::Math::max
+        (
+            bounds_->size() / static_cast<float>(cell_count_per_axis),
+            Magnum::Vector2{0.001f}
+        );
+
+        for(std::size_t i = 0; i < world_space_bounds_.size(); ++i)
+        {
+            const auto& opt_bounds = world_space_bounds_[i];
+            if(!opt_bounds)
+            {
+                continue;
+            }
+
+            const auto min_cell = get_cell(opt_bounds->min());
+            const auto max_cell = get_cell(opt_bounds->max());
+            for(auto y = min_cell.y(); y <= max_cell.y(); ++y)
+            {
+                for(auto x = min_cell.x(); x <= max_cell.x(); ++x)
+                {
+                    cells_[y * cell_count_per_axis + x].push_back(i);
+                }
+            }
+        }
+    }
+
+    revision_ = features::clickable::get_revision();
+    built_ = true;
+}
+
+Magnum::Vector2i hit_test_grid::get_cell(const Magnum::Vector2& world_space_position) const
+{
+    return Magnum::Math::clamp
+    (
+        Magnum::Vector2i{(world_space_position - bounds_->min()) / cell_size_},
+        Magnum::Vector2i{0},
+        Magnum::Vector2i{cell_count_per_axis - 1}
+    );
+}
+
+} //namespace
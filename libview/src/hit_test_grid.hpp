@@ -0,0 +1,88 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBVIEW_HIT_TEST_GRID_HPP
+#define LIBVIEW_HIT_TEST_GRID_HPP
+
+#include <libview/features/clickable.hpp>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Magnum.h>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace libview
+{
+
+/*
+Coarse uniform grid over the world-space bounds of the clickables of a group,
+so that a mouse event is only dispatched to the clickables whose bounds
+contain the pointer.
+
+The grid is lazily rebuilt whenever a clickable has been created, destroyed
+or moved since the last build (see features::clickable::get_revision()).
+*/
+class hit_test_grid
+{
+    public:
+        /*
+        Return the clickables whose bounds contain the given world-space
+        position, as well as the clickables the pointer was inside of at the
+        previous event (so that they get notified of the leave), in group
+        order.
+        The absolute transformations of the returned clickables are clean.
+        */
+        const std::vector<features::clickable*>& get_candidates
+        (
+            features::clickable_group& clickables,
+            const Magnum::Vector2& world_space_position
+        );
+
+    private:
+        void rebuild(features::clickable_group& clickables);
+
+        Magnum::Vector2i get_cell(const Magnum::Vector2& world_space_position) const;
+
+    private:
+        static constexpr auto cell_count_per_axis = 16;
+
+        bool built_ = false;
+        unsigned int revision_ = 0;
+
+        //Union of the world-space bounds of the clickables
+        std::optional<Magnum::Range2D> bounds_;
+        Magnum::Vector2 cell_size_;
+
+        //Indices in group, in ascending order
+        std::vector<std::vector<std::size_t>> cells_;
+        std::vector<std::size_t> unbounded_indices_;
+
+        //Indexed like the group
+        std::vector<features::clickable*> pclickables_;
+        std::vector<std::optional<Magnum::Range2D>> world_space_bounds_;
+
+        //Candidates of the last call (also kept to avoid reallocations)
+        std::vector<std::size_t> candidate_indices_;
+        std::vector<features::clickable*> pcandidates_;
+};
+
+} //namespace
+
+#endif
@@ -75,7 +75,7 @@ adder_tile::adder_tile
 {
     if(show_star)
     {
-        pstar_ = std::make_unique<sdf_image>
+        pstar_ = libutil::make_pooled_unique<sdf_image>
         (
             *this,
             drawables,
@@ -24,6 +24,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include "label.hpp"
 #include "sdf_image.hpp"
 #include "../common.hpp"
+#include <libutil/object_pool.hpp>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Magnum.h>
 
@@ -43,7 +44,7 @@ class adder_tile: public object2d
 
     private:
         rounded_rectangle square_;
-        std::unique_ptr<sdf_image> pstar_;
+        libutil::pooled_unique_ptr<sdf_image> pstar_;
         label label_;
 };
 
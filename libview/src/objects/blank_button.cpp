@@ -57,6 +57,11 @@ void blank_button::set_enabled(const bool enabled)
     enabled_ = enabled;
 }
 
+std::optional<Magnum::Range2D> blank_button::get_bounds() const
+{
+    return Magnum::Range2D{-style_.dimension, style_.dimension};
+}
+
 bool blank_button::do_is_inside(const Magnum::Vector2& model_space_position) const
 {
     if(!enabled_)
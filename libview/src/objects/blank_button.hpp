@@ -62,6 +62,8 @@ class blank_button: public object2d, public features::clickable
 
     //features::clickable virtual functions
     private:
+        std::optional<Magnum::Range2D> get_bounds() const override;
+
         bool do_is_inside(const Magnum::Vector2& model_space_position) const override;
 
         void do_handle_mouse_enter() override;
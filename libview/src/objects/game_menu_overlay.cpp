@@ -22,6 +22,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include "../styles.hpp"
 #include "../colors.hpp"
 #include <libutil/to_string.hpp>
+#include <array>
 #include <cmath>
 
 namespace libview::objects
@@ -42,7 +43,8 @@ namespace
         .alignment = Magnum::Text::Alignment::LineLeft,
         .color = colors::dark_gray,
         .font_size = 0.4f,
-        .outline_range = {0.5f, 1.0f}
+        .outline_range = {0.5f, 1.0f},
+        .capacity = libutil::to_string_buffer_size
     };
 }
 
@@ -136,17 +138,20 @@ game_menu_overlay::game_menu_overlay
 void game_menu_overlay::set_time_s(const int value)
 {
     const auto duration = std::chrono::seconds(value);
-    time_value_label_.set_text(libutil::to_string(duration));
+    auto buffer = std::array<char, libutil::to_string_buffer_size>{};
+    time_value_label_.set_text(libutil::to_string(duration, buffer));
 }
 
 void game_menu_overlay::set_move_count(const int value)
 {
-    move_count_value_label_.set_text(libutil::to_string(value));
+    auto buffer = std::array<char, libutil::to_string_buffer_size>{};
+    move_count_value_label_.set_text(libutil::to_string(value, buffer));
 }
 
 void game_menu_overlay::set_hi_score(const int value)
 {
-    hi_score_value_label_.set_text(libutil::to_string(value));
+    auto buffer = std::array<char, libutil::to_string_buffer_size>{};
+    hi_score_value_label_.set_text(libutil::to_string(value, buffer));
 }
 
 } //namespace
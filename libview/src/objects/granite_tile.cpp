@@ -26,14 +26,14 @@ namespace libview::objects
 
 namespace
 {
-    std::unique_ptr<rounded_rectangle> make_inner_square
+    libutil::pooled_unique_ptr<rounded_rectangle> make_inner_square
     (
         object2d& parent,
         features::drawable_group& drawables,
         const int level
     )
     {
-        auto psquare = std::make_unique<rounded_rectangle>
+        auto psquare = libutil::make_pooled_unique<rounded_rectangle>
         (
             parent,
             drawables,
@@ -50,14 +50,14 @@ namespace
         return psquare;
     }
 
-    std::vector<std::unique_ptr<rounded_rectangle>> make_inner_squares
+    std::vector<libutil::pooled_unique_ptr<rounded_rectangle>> make_inner_squares
     (
         object2d& parent,
         features::drawable_group& drawables,
         const int thickness
     )
     {
-        auto squares = std::vector<std::unique_ptr<rounded_rectangle>>{};
+        auto squares = std::vector<libutil::pooled_unique_ptr<rounded_rectangle>>{};
         for(auto i = 0; i < thickness - 1; ++i)
         {
             squares.push_back(make_inner_square(parent, drawables, i));
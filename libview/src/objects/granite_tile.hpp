@@ -22,6 +22,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "rounded_rectangle.hpp"
 #include "../common.hpp"
+#include <libutil/object_pool.hpp>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Magnum.h>
 
@@ -40,7 +41,7 @@ class granite_tile: public object2d
 
     private:
         rounded_rectangle square_;
-        std::vector<std::unique_ptr<rounded_rectangle>> inner_squares_;
+        std::vector<libutil::pooled_unique_ptr<rounded_rectangle>> inner_squares_;
 };
 
 } //namespace
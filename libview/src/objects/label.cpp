@@ -18,7 +18,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "label.hpp"
-#include "../text.hpp"
+#include <algorithm>
 
 namespace libview::objects
 {
@@ -32,34 +32,37 @@ label::label
 ):
     object2d{&parent},
     features::drawable{*this, &drawables},
-    renderer_(text::get_font(), text::get_glyph_cache(), stl.font_size, stl.alignment),
-    style_(stl)
+    style_(stl),
+    dynamic_text_(stl.font_size, stl.alignment, std::max(stl.capacity, value.size()))
 {
     set_text(value);
 }
 
 void label::set_text(const std::string_view& value)
 {
-    if(value.empty())
-    {
-        visible_ = false;
-        return;
-    }
-
     if(text_ == value)
     {
         return;
     }
     text_ = value;
 
-    renderer_.reserve(value.size(), Magnum::GL::BufferUsage::DynamicDraw, Magnum::GL::BufferUsage::StaticDraw);
-    renderer_.render(value.data());
-    visible_ = true;
+    dynamic_text_.set_text(value);
+    request_redraw();
+}
+
+features::drawable::state label::get_state() const
+{
+    return {.pshader = &text::get_shader(), .ptexture = &text::get_glyph_cache().texture()};
+}
+
+std::optional<Magnum::Range2D> label::get_bounds() const
+{
+    return dynamic_text_.get_bounds();
 }
 
 void label::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
 {
-    if(visible_)
+    if(dynamic_text_.get_glyph_count() != 0)
     {
         const auto absolute_alpha = get_absolute_alpha();
 
@@ -69,7 +72,7 @@ void label::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
         text::get_shader().setSmoothness(0.035f / (transformation_matrix.uniformScaling() * style_.font_size));
         text::get_shader().setOutlineColor(style_.outline_color * absolute_alpha);
         text::get_shader().setOutlineRange(style_.outline_range[0], style_.outline_range[1]);
-        text::get_shader().draw(renderer_.mesh());
+        text::get_shader().draw(dynamic_text_.get_mesh());
     }
 }
 
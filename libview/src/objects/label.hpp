@@ -20,10 +20,13 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBVIEW_OBJECTS_LABEL_HPP
 #define LIBVIEW_OBJECTS_LABEL_HPP
 
+#include "../text.hpp"
 #include "../common.hpp"
-#include <Magnum/Text/Renderer.h>
+#include <Magnum/Text/Alignment.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Magnum.h>
+#include <cstddef>
+#include <string>
 #include <string_view>
 
 namespace libview::objects
@@ -39,6 +42,10 @@ class label: public object2d, public features::drawable
             const float font_size = 1.0f;
             Magnum::Color4 outline_color;
             Magnum::Vector2 outline_range = {0.5f, 0.5f};
+
+            //Expected maximum glyph count of the text, so that its buffers are
+            //allocated once (see text::dynamic_text)
+            std::size_t capacity = 0;
         };
 
     public:
@@ -55,20 +62,25 @@ class label: public object2d, public features::drawable
         void set_color(const Magnum::Color4& color)
         {
             style_.color = color;
+            request_redraw();
         }
 
         void set_outline_color(const Magnum::Color4& outline_color)
         {
             style_.outline_color = outline_color;
+            request_redraw();
         }
 
     private:
         void draw(const Magnum::Matrix3& transformation_matrix, camera& camera) override;
 
+        state get_state() const override;
+
+        std::optional<Magnum::Range2D> get_bounds() const override;
+
     private:
-        Magnum::Text::Renderer2D renderer_;
         style style_;
-        bool visible_ = true;
+        text::dynamic_text dynamic_text_;
         std::string text_;
 };
 
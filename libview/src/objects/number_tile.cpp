@@ -93,11 +93,10 @@ namespace
         return lighter(get_square_color(value));
     }
 
-    std::unique_ptr<shine> make_shine
+    libutil::pooled_unique_ptr<shine> make_shine
     (
         object2d& parent,
         features::drawable_group& drawables,
-        features::animable_group& animables,
         const shine::style& style,
         const int value
     )
@@ -107,11 +106,10 @@ namespace
             return nullptr;
         }
 
-        auto pshine = std::make_unique<shine>
+        auto pshine = libutil::make_pooled_unique<shine>
         (
             parent,
             drawables,
-            animables,
             style
         );
         pshine->setScaling({1.7f, 1.7f});
@@ -119,10 +117,10 @@ namespace
         return pshine;
     }
 
-    std::unique_ptr<rounded_rectangle> make_glow
+    libutil::pooled_unique_ptr<tile_batch::rounded_rectangle> make_glow
     (
         object2d& parent,
-        features::drawable_group& drawables,
+        tile_batch& batch,
         const int value
     )
     {
@@ -131,11 +129,11 @@ namespace
             return nullptr;
         }
 
-        auto pglow = std::make_unique<rounded_rectangle>
+        auto pglow = libutil::make_pooled_unique<tile_batch::rounded_rectangle>
         (
             parent,
-            drawables,
-            rounded_rectangle::style
+            batch,
+            tile_batch::rounded_rectangle::style
             {
                 .color = get_glow_color(value),
                 .radius = 0.7f,
@@ -152,19 +150,19 @@ namespace
 number_tile::number_tile
 (
     object2d& parent,
-    features::drawable_group& drawables,
+    tile_batch& batch,
     features::animable_group& animables,
     const int value
 ):
     object2d(&parent),
     features::animable(*this, &animables),
+    batch_(batch),
     pshine0_
     (
         make_shine
         (
             *this,
-            drawables,
-            animables,
+            batch.get_underlay_drawables(),
             shine::style
             {
                 .color = get_shine_color(value),
@@ -180,8 +178,7 @@ number_tile::number_tile
         make_shine
         (
             *this,
-            drawables,
-            animables,
+            batch.get_underlay_drawables(),
             shine::style
             {
                 .color = get_shine_color(value),
@@ -195,19 +192,19 @@ number_tile::number_tile
     square_
     (
         *this,
-        drawables,
-        rounded_rectangle::style
+        batch,
+        tile_batch::rounded_rectangle::style
         {
             .color = get_square_color(value),
             .radius = 0.6f
         }
     ),
-    pglow_(make_glow(*this, drawables, value)),
+    pglow_(make_glow(*this, batch, value)),
     label_
     (
         *this,
-        drawables,
-        label::style
+        batch,
+        tile_batch::label::style
         {
             .alignment = Magnum::Text::Alignment::MiddleCenter,
             .color = colors::white,
@@ -215,19 +212,40 @@ number_tile::number_tile
             .outline_color = darker(get_square_color(value)),
             .outline_range = {0.45f, 0.40f}
         },
-        get_label_text(value).c_str()
+        get_label_text(value)
     )
 {
 }
 
 void number_tile::advance(const std::chrono::steady_clock::time_point& /*now*/, float elapsed_s)
 {
+    if(!is_animating())
+    {
+        return;
+    }
+
     if(pglow_)
     {
         glow_cycle_ = std::fmodf(glow_cycle_ + (elapsed_s * 2), 2 * M_PI);
         const auto glow_alpha = std::sinf(glow_cycle_) / 2.0f + 0.5f;
         pglow_->set_alpha(glow_alpha);
     }
+
+    if(pshine0_)
+    {
+        pshine0_->advance(elapsed_s);
+    }
+
+    if(pshine1_)
+    {
+        pshine1_->advance(elapsed_s);
+    }
+}
+
+bool number_tile::is_animating() const
+{
+    //Don't keep the view busy for invisible or frozen decorations
+    return (pglow_ || pshine0_ || pshine1_) && !batch_.is_paused() && get_absolute_alpha() > 0;
 }
 
 } //namespace
@@ -21,9 +21,9 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBVIEW_OBJECTS_NUMBER_TILE_HPP
 
 #include "shine.hpp"
-#include "rounded_rectangle.hpp"
-#include "label.hpp"
+#include "tile_batch.hpp"
 #include "../common.hpp"
+#include <libutil/object_pool.hpp>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Magnum.h>
 
@@ -36,20 +36,23 @@ class number_tile: public object2d, public features::animable
         number_tile
         (
             object2d& parent,
-            features::drawable_group& drawables,
+            tile_batch& batch,
             features::animable_group& animables,
             const int value
         );
 
-        void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s);
+        void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s) override;
+
+        bool is_animating() const override;
 
     private:
-        std::unique_ptr<shine> pshine0_;
-        std::unique_ptr<shine> pshine1_;
-        rounded_rectangle square_;
-        std::unique_ptr<rounded_rectangle> pglow_;
+        const tile_batch& batch_;
+        libutil::pooled_unique_ptr<shine> pshine0_;
+        libutil::pooled_unique_ptr<shine> pshine1_;
+        tile_batch::rounded_rectangle square_;
+        libutil::pooled_unique_ptr<tile_batch::rounded_rectangle> pglow_;
         float glow_cycle_ = reinterpret_cast<int>(this) / 1000.0f; //cheap random
-        label label_;
+        tile_batch::label label_;
 };
 
 } //namespace
@@ -57,6 +57,17 @@ rounded_rectangle::rounded_rectangle
 void rounded_rectangle::set_color(const Magnum::Color4& color)
 {
     style_.color = color;
+    request_redraw();
+}
+
+features::drawable::state rounded_rectangle::get_state() const
+{
+    return {.pshader = &get_shader()};
+}
+
+std::optional<Magnum::Range2D> rounded_rectangle::get_bounds() const
+{
+    return Magnum::Range2D{-style_.dimension, style_.dimension};
 }
 
 void rounded_rectangle::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
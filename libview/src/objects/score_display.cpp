@@ -18,12 +18,12 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "score_display.hpp"
-#include "../text.hpp"
 #include "../colors.hpp"
 #include <libutil/to_string.hpp>
 #include <Magnum/Shaders/Vector.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/GlyphCache.h>
+#include <array>
 
 namespace libview::objects
 {
@@ -31,15 +31,26 @@ namespace libview::objects
 score_display::score_display(object2d& parent, features::drawable_group& drawables):
     object2d{&parent},
     features::drawable{*this, &drawables},
-    renderer_(text::get_font(), text::get_glyph_cache(), 1.0f, Magnum::Text::Alignment::TopRight)
+    dynamic_text_(1.0f, Magnum::Text::Alignment::TopRight, libutil::to_string_buffer_size)
 {
-    renderer_.reserve(40, Magnum::GL::BufferUsage::DynamicDraw, Magnum::GL::BufferUsage::StaticDraw);
-    renderer_.render("0");
+    dynamic_text_.set_text("0");
 }
 
 void score_display::set_score(const int value)
 {
-    renderer_.render(libutil::to_string(value));
+    auto buffer = std::array<char, libutil::to_string_buffer_size>{};
+    dynamic_text_.set_text(libutil::to_string(value, buffer));
+    request_redraw();
+}
+
+features::drawable::state score_display::get_state() const
+{
+    return {.pshader = &text::get_shader(), .ptexture = &text::get_glyph_cache().texture()};
+}
+
+std::optional<Magnum::Range2D> score_display::get_bounds() const
+{
+    return dynamic_text_.get_bounds();
 }
 
 void score_display::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
@@ -52,7 +63,7 @@ void score_display::draw(const Magnum::Matrix3& transformation_matrix, camera& c
     text::get_shader().setSmoothness(0.035f / transformation_matrix.uniformScaling());
     text::get_shader().setOutlineColor(colors::dark_gray * absolute_alpha);
     text::get_shader().setOutlineRange(0.47, 0.40);
-    text::get_shader().draw(renderer_.mesh());
+    text::get_shader().draw(dynamic_text_.get_mesh());
 }
 
 } //namespace
@@ -20,8 +20,8 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBVIEW_OBJECTS_SCORE_DISPLAY_HPP
 #define LIBVIEW_OBJECTS_SCORE_DISPLAY_HPP
 
+#include "../text.hpp"
 #include "../common.hpp"
-#include <Magnum/Text/Renderer.h>
 
 namespace libview::objects
 {
@@ -36,8 +36,12 @@ class score_display: public object2d, public features::drawable
     private:
         void draw(const Magnum::Matrix3& transformation_matrix, camera& camera) override;
 
+        state get_state() const override;
+
+        std::optional<Magnum::Range2D> get_bounds() const override;
+
     private:
-        Magnum::Text::Renderer2D renderer_;
+        text::dynamic_text dynamic_text_;
 };
 
 } //namespace
@@ -28,6 +28,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/ImageView.h>
 #include <Corrade/Containers/Optional.h>
+#include <filesystem>
 
 namespace libview::objects
 {
@@ -48,7 +49,10 @@ namespace
 
     Magnum::Shaders::DistanceFieldVector2D& get_shader()
     {
-        static Magnum::Shaders::DistanceFieldVector2D shader;
+        static Magnum::Shaders::DistanceFieldVector2D shader
+        {
+            Magnum::Shaders::DistanceFieldVector2D::Flag::TextureTransformation
+        };
         return shader;
     }
 
@@ -70,6 +74,34 @@ namespace
         return texture;
     }
 
+    /*
+    Return the atlas texture, decoding and uploading it only if no other
+    sdf_image currently uses it.
+    */
+    std::shared_ptr<Magnum::GL::Texture2D> get_atlas_texture()
+    {
+        static auto pweak_texture = std::weak_ptr<Magnum::GL::Texture2D>{};
+
+        if(auto ptexture = pweak_texture.lock())
+        {
+            return ptexture;
+        }
+
+        auto ptexture = std::make_shared<Magnum::GL::Texture2D>(make_texture(libres::images::atlas_path));
+        pweak_texture = ptexture;
+        return ptexture;
+    }
+
+    //Map the texture coordinates of the mesh to the given image of the atlas
+    Magnum::Matrix3 make_texture_matrix(const libres::images::image& img)
+    {
+        const auto uv = img.get_uv_rect();
+        return
+            Magnum::Matrix3::translation({uv.left, uv.bottom}) *
+            Magnum::Matrix3::scaling({uv.right - uv.left, uv.top - uv.bottom})
+        ;
+    }
+
     /*
     We want the object scaling to be applied to the original PNG image
     (i.e. WITHOUT the distance field). To do so, we must upscale the object
@@ -85,24 +117,37 @@ sdf_image::sdf_image
 (
     object2d& parent,
     features::drawable_group& drawables,
-    const std::filesystem::path& image_path,
+    const libres::images::image& img,
     const style& stl
 ):
     object2d{&parent},
     features::drawable{*this, &drawables},
     style_(stl),
-    texture_(make_texture(image_path))
+    ptexture_(get_atlas_texture()),
+    texture_matrix_(make_texture_matrix(img))
 {
 }
 
 void sdf_image::set_color(const Magnum::Color4& color)
 {
     style_.color = color;
+    request_redraw();
 }
 
 void sdf_image::set_outline_color(const Magnum::Color4& color)
 {
     style_.outline_color = color;
+    request_redraw();
+}
+
+features::drawable::state sdf_image::get_state() const
+{
+    return {.pshader = &get_shader(), .ptexture = ptexture_.get()};
+}
+
+std::optional<Magnum::Range2D> sdf_image::get_bounds() const
+{
+    return Magnum::Range2D{{-scaling_factor, -scaling_factor}, {scaling_factor, scaling_factor}};
 }
 
 void sdf_image::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
@@ -110,7 +155,8 @@ void sdf_image::draw(const Magnum::Matrix3& transformation_matrix, camera& camer
     const auto absolute_alpha = get_absolute_alpha();
 
     get_shader().setColor(style_.color * absolute_alpha);
-    get_shader().bindVectorTexture(texture_);
+    get_shader().bindVectorTexture(*ptexture_);
+    get_shader().setTextureMatrix(texture_matrix_);
     get_shader().setTransformationProjectionMatrix(camera.projectionMatrix() * transformation_matrix * scaling_matrix);
     get_shader().setSmoothness(0.15f / transformation_matrix.uniformScaling());
     get_shader().setOutlineColor(style_.outline_color * absolute_alpha);
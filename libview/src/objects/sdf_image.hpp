@@ -21,10 +21,12 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBVIEW_OBJECTS_SDF_IMAGE_HPP
 
 #include "../common.hpp"
+#include <libres.hpp>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix3.h>
 #include <Magnum/Magnum.h>
-#include <filesystem>
+#include <memory>
 
 namespace libview::objects
 {
@@ -45,7 +47,7 @@ class sdf_image: public object2d, public features::drawable
         (
             object2d& parent,
             features::drawable_group& drawables,
-            const std::filesystem::path& image_path,
+            const libres::images::image& img,
             const style& stl
         );
 
@@ -56,9 +58,18 @@ class sdf_image: public object2d, public features::drawable
     private:
         void draw(const Magnum::Matrix3& transformation_matrix, camera& camera) override;
 
+        state get_state() const override;
+
+        std::optional<Magnum::Range2D> get_bounds() const override;
+
     private:
         style style_;
-        Magnum::GL::Texture2D texture_;
+
+        //Atlas, shared by all the sdf_image objects
+        std::shared_ptr<Magnum::GL::Texture2D> ptexture_;
+
+        //Location of the image in the atlas
+        Magnum::Matrix3 texture_matrix_;
 };
 
 } //namespace
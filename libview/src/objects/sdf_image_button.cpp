@@ -34,7 +34,7 @@ sdf_image_button::sdf_image_button
     object2d& parent,
     features::drawable_group& drawables,
     features::clickable_group& clickables,
-    const std::filesystem::path& image_path,
+    const libres::images::image& img,
     const callback_set& callbacks
 ):
     object2d{&parent},
@@ -44,7 +44,7 @@ sdf_image_button::sdf_image_button
     (
         *this,
         drawables,
-        image_path,
+        img,
         sdf_image::style
         {
             .color = colors::light_gray,
@@ -55,6 +55,11 @@ sdf_image_button::sdf_image_button
 {
 }
 
+std::optional<Magnum::Range2D> sdf_image_button::get_bounds() const
+{
+    return Magnum::Range2D{{-1.0f, -1.0f}, {1.0f, 1.0f}};
+}
+
 bool sdf_image_button::do_is_inside(const Magnum::Vector2& model_space_position) const
 {
     const auto x = model_space_position.x();
@@ -42,12 +42,14 @@ class sdf_image_button: public object2d, public features::clickable
             object2d& parent,
             features::drawable_group& drawables,
             features::clickable_group& clickables,
-            const std::filesystem::path& image_path,
+            const libres::images::image& img,
             const callback_set& callbacks
         );
 
     //features::clickable virtual functions
     private:
+        std::optional<Magnum::Range2D> get_bounds() const override;
+
         bool do_is_inside(const Magnum::Vector2& model_space_position) const override;
 
         void do_handle_mouse_press() override;
@@ -31,7 +31,7 @@ sdf_image_tile::sdf_image_tile
 (
     object2d& parent,
     features::drawable_group& drawables,
-    const std::vector<std::filesystem::path>& image_paths
+    const std::vector<libres::images::image>& imgs
 ):
     object2d{&parent},
     square_
@@ -48,13 +48,13 @@ sdf_image_tile::sdf_image_tile
         }
     )
 {
-    for(const auto& image_path: image_paths)
+    for(const auto& img: imgs)
     {
-        auto pimage = std::make_unique<sdf_image>
+        auto pimage = libutil::make_pooled_unique<sdf_image>
         (
             *this,
             drawables,
-            image_path,
+            img,
             sdf_image::style
             {
                 .color = colors::black,
@@ -23,9 +23,9 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include "sdf_image.hpp"
 #include "rounded_rectangle.hpp"
 #include "../common.hpp"
+#include <libutil/object_pool.hpp>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Magnum.h>
-#include <filesystem>
 #include <vector>
 #include <memory>
 
@@ -39,12 +39,12 @@ class sdf_image_tile: public object2d
         (
             object2d& parent,
             features::drawable_group& drawables,
-            const std::vector<std::filesystem::path>& image_paths
+            const std::vector<libres::images::image>& imgs
         );
 
     private:
         rounded_rectangle square_;
-        std::vector<std::unique_ptr<sdf_image>> images_;
+        std::vector<libutil::pooled_unique_ptr<sdf_image>> images_;
 };
 
 } //namespace
@@ -47,16 +47,24 @@ shine::shine
 (
     object2d& parent,
     features::drawable_group& drawables,
-    features::animable_group& animables,
     const style& stl
 ):
     object2d{&parent},
     features::drawable{*this, &drawables},
-    features::animable{*this, &animables},
     style_(stl)
 {
 }
 
+features::drawable::state shine::get_state() const
+{
+    return {.pshader = &get_shader()};
+}
+
+std::optional<Magnum::Range2D> shine::get_bounds() const
+{
+    return Magnum::Range2D{{-1.0f, -1.0f}, {1.0f, 1.0f}};
+}
+
 void shine::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
 {
     get_shader().set_color(style_.color * get_absolute_alpha());
@@ -72,7 +80,7 @@ void shine::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
     get_shader().draw(get_mesh());
 }
 
-void shine::advance(const std::chrono::steady_clock::time_point& /*now*/, const float elapsed_s)
+void shine::advance(const float elapsed_s)
 {
     angle_rad_ = std::fmodf(angle_rad_ + elapsed_s * style_.speed_radps, 2 * M_PI);
 }
@@ -21,14 +21,17 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBVIEW_OBJECTS_SHINE_HPP
 
 #include "../common.hpp"
-#include <chrono>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Magnum.h>
 
 namespace libview::objects
 {
 
-class shine: public object2d, public features::drawable, public features::animable
+/*
+Not an animable: the owner calls advance(), so that it can decide when the
+shine has to be animated.
+*/
+class shine: public object2d, public features::drawable
 {
     public:
         struct style
@@ -44,14 +47,17 @@ class shine: public object2d, public features::drawable, public features::animab
         (
             object2d& parent,
             features::drawable_group& drawables,
-            features::animable_group& animables,
             const style& stl
         );
 
+        void advance(float elapsed_s);
+
     private:
         void draw(const Magnum::Matrix3& transformation_matrix, camera& camera) override;
 
-        void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s) override;
+        state get_state() const override;
+
+        std::optional<Magnum::Range2D> get_bounds() const override;
 
     private:
         style style_;
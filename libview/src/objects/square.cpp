@@ -52,6 +52,17 @@ square::square(object2d& parent, features::drawable_group& drawables, const Magn
 void square::set_color(const Magnum::Color4& color)
 {
     color_ = color;
+    request_redraw();
+}
+
+features::drawable::state square::get_state() const
+{
+    return {.pshader = &get_shader()};
+}
+
+std::optional<Magnum::Range2D> square::get_bounds() const
+{
+    return Magnum::Range2D{{-1.0f, -1.0f}, {1.0f, 1.0f}};
 }
 
 void square::draw(const Magnum::Matrix3& transformation_matrix, camera& camera)
@@ -37,6 +37,10 @@ class square: public object2d, public features::drawable
     private:
         void draw(const Magnum::Matrix3& transformation_matrix, camera& camera) override;
 
+        state get_state() const override;
+
+        std::optional<Magnum::Range2D> get_bounds() const override;
+
     private:
         Magnum::Color4 color_;
 };
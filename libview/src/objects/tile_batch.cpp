@@ -0,0 +1,366 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tile_batch.hpp"
+#include "../shaders/rounded_rectangle_batch.hpp"
+#include "../shaders/distance_field_batch.hpp"
+#include "../text.hpp"
+#include <libutil/overload.hpp>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace libview::objects
+{
+
+namespace
+{
+    //Indices are 16-bit, as 32-bit indices are an extension on WebGL 1
+    constexpr auto max_vertex_count = std::size_t{std::numeric_limits<Magnum::UnsignedShort>::max()} + 1;
+
+    shaders::rounded_rectangle_batch& get_rectangle_shader()
+    {
+        static shaders::rounded_rectangle_batch shader;
+        return shader;
+    }
+
+    shaders::distance_field_batch& get_glyph_shader()
+    {
+        static shaders::distance_field_batch shader;
+        return shader;
+    }
+
+    //Corners of the unit square, in the order expected by quad_indices
+    constexpr auto unit_square_corners = std::array<Magnum::Vector2, 4>
+    {
+        Magnum::Vector2{-1.0f, -1.0f},
+        Magnum::Vector2{ 1.0f, -1.0f},
+        Magnum::Vector2{-1.0f,  1.0f},
+        Magnum::Vector2{ 1.0f,  1.0f}
+    };
+
+    constexpr auto quad_indices = std::array<Magnum::UnsignedShort, 6>{0, 1, 2, 2, 1, 3};
+
+    //Return the bounding box of the given non-empty range of vertices
+    template<class VertexIterator>
+    Magnum::Range2D get_bounds(const VertexIterator first, const VertexIterator last)
+    {
+        auto min = first->position;
+        auto max = first->position;
+        for(auto it = first; it != last; ++it)
+        {
+            min = Magnum::Math::min(min, it->position);
+            max = Magnum::Math::max(max, it->position);
+        }
+        return Magnum::Range2D{min, max};
+    }
+
+    bool overlap(const Magnum::Range2D& lhs, const Magnum::Range2D& rhs)
+    {
+        return
+            lhs.min().x() < rhs.max().x() && rhs.min().x() < lhs.max().x() &&
+            lhs.min().y() < rhs.max().y() && rhs.min().y() < lhs.max().y()
+        ;
+    }
+}
+
+tile_batch::rounded_rectangle::rounded_rectangle
+(
+    object2d& parent,
+    tile_batch& batch,
+    const style& stl
+):
+    object2d{&parent},
+    batch_(batch),
+    style_(stl)
+{
+    batch_.members_.push_back(this);
+}
+
+tile_batch::rounded_rectangle::~rounded_rectangle()
+{
+    std::erase(batch_.members_, member{this});
+}
+
+tile_batch::label::label
+(
+    object2d& parent,
+    tile_batch& batch,
+    const style& stl,
+    const std::string_view& value
+):
+    object2d{&parent},
+    batch_(batch),
+    style_(stl),
+    layout_(text::get_layout(value, stl.font_size, stl.alignment))
+{
+    batch_.members_.push_back(this);
+}
+
+tile_batch::label::~label()
+{
+    std::erase(batch_.members_, member{this});
+}
+
+tile_batch::tile_batch(object2d& parent, features::drawable_group& drawables):
+    object2d{&parent},
+    features::drawable{*this, &drawables},
+    rectangle_vertex_buffer_{Magnum::GL::Buffer::TargetHint::Array},
+    glyph_vertex_buffer_{Magnum::GL::Buffer::TargetHint::Array},
+    index_buffer_{Magnum::GL::Buffer::TargetHint::ElementArray}
+{
+    using rectangle_shader = shaders::rounded_rectangle_batch;
+    rectangle_mesh_
+        .setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
+        .addVertexBuffer
+        (
+            rectangle_vertex_buffer_,
+            0,
+            rectangle_shader::Position{},
+            rectangle_shader::LocalPosition{},
+            rectangle_shader::Color{},
+            rectangle_shader::OutlineColor{},
+            rectangle_shader::Dimension{},
+            rectangle_shader::Shape{}
+        )
+        .setIndexBuffer(index_buffer_, 0, Magnum::GL::MeshIndexType::UnsignedShort)
+    ;
+
+    using glyph_shader = shaders::distance_field_batch;
+    glyph_mesh_
+        .setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
+        .addVertexBuffer
+        (
+            glyph_vertex_buffer_,
+            0,
+            glyph_shader::Position{},
+            glyph_shader::TextureCoordinates{},
+            glyph_shader::Color{},
+            glyph_shader::OutlineColor{},
+            glyph_shader::Shape{}
+        )
+        .setIndexBuffer(index_buffer_, 0, Magnum::GL::MeshIndexType::UnsignedShort)
+    ;
+}
+
+void tile_batch::draw(const Magnum::Matrix3& /*transformation_matrix*/, camera& camera)
+{
+    camera.draw(underlay_drawables_);
+
+    const auto camera_matrix = camera.cameraMatrix();
+    const auto projection_matrix = camera.projectionMatrix();
+
+    for(const auto& item: members_)
+    {
+        std::visit
+        (
+            libutil::overload
+            {
+                [&](const rounded_rectangle* prectangle)
+                {
+                    add_rectangle(*prectangle, camera_matrix, projection_matrix);
+                },
+                [&](const label* plabel)
+                {
+                    add_label(*plabel, camera_matrix, projection_matrix);
+                }
+            },
+            item
+        );
+    }
+
+    submit();
+}
+
+void tile_batch::add_rectangle
+(
+    const rounded_rectangle& rectangle,
+    const Magnum::Matrix3& camera_matrix,
+    const Magnum::Matrix3& projection_matrix
+)
+{
+    const auto absolute_alpha = rectangle.get_absolute_alpha();
+    if(absolute_alpha <= 0)
+    {
+        return;
+    }
+
+    const auto& stl = rectangle.style_;
+    const auto transformation_matrix = camera_matrix * rectangle.absoluteTransformationMatrix();
+    const auto transformation_projection_matrix = projection_matrix * transformation_matrix;
+    const auto color = stl.color * absolute_alpha;
+    const auto outline_color = stl.outline_color * absolute_alpha;
+    const auto shape = Magnum::Vector3
+    {
+        stl.radius,
+        stl.smoothness_factor * 0.03f / transformation_matrix.scaling().x(),
+        stl.outline_thickness
+    };
+
+    auto vertices = std::array<rectangle_vertex, unit_square_corners.size()>{};
+    for(auto i = std::size_t{0}; i < unit_square_corners.size(); ++i)
+    {
+        const auto& corner = unit_square_corners[i];
+        vertices[i] = rectangle_vertex
+        {
+            .position = transformation_projection_matrix.transformPoint(corner),
+            .local_position = corner,
+            .color = color,
+            .outline_color = outline_color,
+            .dimension = stl.dimension,
+            .shape = shape
+        };
+    }
+
+    //Pending labels are drawn after the pending rectangles. If this rectangle
+    //covers one of them, draw them first.
+    if(opt_pending_label_bounds_union_)
+    {
+        const auto bounds = get_bounds(vertices.begin(), vertices.end());
+        if(overlap(bounds, *opt_pending_label_bounds_union_))
+        {
+            const auto covers_label = std::any_of
+            (
+                pending_label_bounds_.begin(),
+                pending_label_bounds_.end(),
+                [&](const Magnum::Range2D& label_bounds)
+                {
+                    return overlap(bounds, label_bounds);
+                }
+            );
+
+            if(covers_label)
+            {
+                submit();
+            }
+        }
+    }
+
+    if(rectangle_vertices_.size() + vertices.size() > max_vertex_count)
+    {
+        submit();
+    }
+
+    const auto first_index = static_cast<Magnum::UnsignedShort>(rectangle_vertices_.size());
+    rectangle_vertices_.insert(rectangle_vertices_.end(), vertices.begin(), vertices.end());
+    for(const auto index: quad_indices)
+    {
+        rectangle_indices_.push_back(static_cast<Magnum::UnsignedShort>(first_index + index));
+    }
+}
+
+void tile_batch::add_label
+(
+    const label& lbl,
+    const Magnum::Matrix3& camera_matrix,
+    const Magnum::Matrix3& projection_matrix
+)
+{
+    const auto absolute_alpha = lbl.get_absolute_alpha();
+    const auto& layout = lbl.layout_;
+
+    if(absolute_alpha <= 0 || layout.positions.empty())
+    {
+        return;
+    }
+
+    if(glyph_vertices_.size() + layout.positions.size() > max_vertex_count)
+    {
+        submit();
+    }
+
+    const auto& stl = lbl.style_;
+    const auto transformation_matrix = camera_matrix * lbl.absoluteTransformationMatrix();
+    const auto transformation_projection_matrix = projection_matrix * transformation_matrix;
+    const auto color = stl.color * absolute_alpha;
+    const auto outline_color = stl.outline_color * absolute_alpha;
+    const auto shape = Magnum::Vector3
+    {
+        stl.outline_range[0],
+        stl.outline_range[1],
+        0.035f / (transformation_matrix.uniformScaling() * stl.font_size)
+    };
+
+    const auto first_index = static_cast<Magnum::UnsignedShort>(glyph_vertices_.size());
+    for(auto i = std::size_t{0}; i < layout.positions.size(); ++i)
+    {
+        glyph_vertices_.push_back
+        (
+            glyph_vertex
+            {
+                .position = transformation_projection_matrix.transformPoint(layout.positions[i]),
+                .texture_coordinates = layout.texture_coordinates[i],
+                .color = color,
+                .outline_color = outline_color,
+                .shape = shape
+            }
+        );
+    }
+    for(const auto index: layout.indices)
+    {
+        glyph_indices_.push_back(static_cast<Magnum::UnsignedShort>(first_index + index));
+    }
+
+    const auto bounds = get_bounds(glyph_vertices_.begin() + first_index, glyph_vertices_.end());
+    const auto& opt_union = opt_pending_label_bounds_union_;
+    opt_pending_label_bounds_union_ = opt_union ? Magnum::Math::join(*opt_union, bounds) : bounds;
+    pending_label_bounds_.push_back(bounds);
+}
+
+void tile_batch::submit()
+{
+    submit_rectangles();
+    submit_glyphs();
+    pending_label_bounds_.clear();
+    opt_pending_label_bounds_union_.reset();
+}
+
+void tile_batch::submit_rectangles()
+{
+    if(!rectangle_indices_.empty())
+    {
+        rectangle_vertex_buffer_.setData(Corrade::Containers::arrayView(rectangle_vertices_), Magnum::GL::BufferUsage::StreamDraw);
+        index_buffer_.setData(Corrade::Containers::arrayView(rectangle_indices_), Magnum::GL::BufferUsage::StreamDraw);
+        rectangle_mesh_.setCount(static_cast<Magnum::Int>(rectangle_indices_.size()));
+        get_rectangle_shader().draw(rectangle_mesh_);
+    }
+
+    rectangle_vertices_.clear();
+    rectangle_indices_.clear();
+}
+
+void tile_batch::submit_glyphs()
+{
+    if(!glyph_indices_.empty())
+    {
+        glyph_vertex_buffer_.setData(Corrade::Containers::arrayView(glyph_vertices_), Magnum::GL::BufferUsage::StreamDraw);
+        index_buffer_.setData(Corrade::Containers::arrayView(glyph_indices_), Magnum::GL::BufferUsage::StreamDraw);
+        glyph_mesh_.setCount(static_cast<Magnum::Int>(glyph_indices_.size()));
+        get_glyph_shader()
+            .bind_texture(text::get_glyph_cache().texture())
+            .draw(glyph_mesh_)
+        ;
+    }
+
+    glyph_vertices_.clear();
+    glyph_indices_.clear();
+}
+
+} //namespace
@@ -0,0 +1,225 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBVIEW_OBJECTS_TILE_BATCH_HPP
+#define LIBVIEW_OBJECTS_TILE_BATCH_HPP
+
+#include "rounded_rectangle.hpp"
+#include "label.hpp"
+#include "../text.hpp"
+#include "../common.hpp"
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Magnum.h>
+#include <optional>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace libview::objects
+{
+
+/*
+Draws the rounded rectangles and the labels of many tiles with few draw calls
+(usually one for all the rectangles and one for all the glyphs).
+
+Members of the batch (tile_batch::rounded_rectangle and tile_batch::label) are
+regular objects of the scene graph, so that they can be transformed and
+animated like any other object, but they don't draw themselves.
+Instead, every frame, the batch reads their absolute transformation and alpha,
+writes everything into vertex buffers, and draws them all at once.
+Rectangles are drawn before labels. To keep the creation order of overlapping
+members (e.g. a tile moving over another one during a merge), the batch is
+split wherever a rectangle covers a label created before it.
+
+The batch must outlive its members.
+*/
+class tile_batch: public object2d, public features::drawable
+{
+    public:
+        //Same as objects::rounded_rectangle, but drawn by a tile_batch
+        class rounded_rectangle: public object2d
+        {
+            public:
+                using style = objects::rounded_rectangle::style;
+
+            public:
+                rounded_rectangle
+                (
+                    object2d& parent,
+                    tile_batch& batch,
+                    const style& stl
+                );
+
+                rounded_rectangle(const rounded_rectangle&) = delete;
+
+                ~rounded_rectangle();
+
+                rounded_rectangle& operator=(const rounded_rectangle&) = delete;
+
+                void set_color(const Magnum::Color4& color)
+                {
+                    style_.color = color;
+                    request_redraw();
+                }
+
+            private:
+                friend class tile_batch;
+
+                tile_batch& batch_;
+                style style_;
+        };
+
+        /*
+        Same as objects::label, but drawn by a tile_batch and with a fixed
+        text, whose layout is shared with the other labels that show the same
+        text (see text::get_layout()).
+        */
+        class label: public object2d
+        {
+            public:
+                using style = objects::label::style;
+
+            public:
+                label
+                (
+                    object2d& parent,
+                    tile_batch& batch,
+                    const style& stl,
+                    const std::string_view& value
+                );
+
+                label(const label&) = delete;
+
+                ~label();
+
+                label& operator=(const label&) = delete;
+
+            private:
+                friend class tile_batch;
+
+                tile_batch& batch_;
+                style style_;
+                const text::layout& layout_;
+        };
+
+    public:
+        tile_batch(object2d& parent, features::drawable_group& drawables);
+
+        /*
+        Drawables of this group are drawn by the batch, just before its
+        members.
+        This is for the tile effects that need their own shader (e.g. shines)
+        and must stay below the tiles.
+        */
+        features::drawable_group& get_underlay_drawables()
+        {
+            return underlay_drawables_;
+        }
+
+        /*
+        Whether the decoration animations of the tiles drawn by the batch
+        (glows, shines) are frozen, e.g. while the game is paused.
+        */
+        bool is_paused() const
+        {
+            return paused_;
+        }
+
+        void set_paused(const bool value)
+        {
+            paused_ = value;
+        }
+
+    private:
+        struct rectangle_vertex
+        {
+            Magnum::Vector2 position;
+            Magnum::Vector2 local_position;
+            Magnum::Color4 color;
+            Magnum::Color4 outline_color;
+            Magnum::Vector2 dimension;
+            Magnum::Vector3 shape;
+        };
+
+        struct glyph_vertex
+        {
+            Magnum::Vector2 position;
+            Magnum::Vector2 texture_coordinates;
+            Magnum::Color4 color;
+            Magnum::Color4 outline_color;
+            Magnum::Vector3 shape;
+        };
+
+        using member = std::variant<rounded_rectangle*, label*>;
+
+    private:
+        void draw(const Magnum::Matrix3& transformation_matrix, camera& camera) override;
+
+        void add_rectangle
+        (
+            const rounded_rectangle& rectangle,
+            const Magnum::Matrix3& camera_matrix,
+            const Magnum::Matrix3& projection_matrix
+        );
+
+        void add_label
+        (
+            const label& lbl,
+            const Magnum::Matrix3& camera_matrix,
+            const Magnum::Matrix3& projection_matrix
+        );
+
+        //Draw the pending rectangles, then the pending labels
+        void submit();
+
+        void submit_rectangles();
+
+        void submit_glyphs();
+
+    private:
+        features::drawable_group underlay_drawables_;
+        bool paused_ = false;
+
+        //In creation order
+        std::vector<member> members_;
+
+        //Kept from one frame to the next to avoid reallocations
+        std::vector<rectangle_vertex> rectangle_vertices_;
+        std::vector<glyph_vertex> glyph_vertices_;
+        std::vector<Magnum::UnsignedShort> rectangle_indices_;
+        std::vector<Magnum::UnsignedShort> glyph_indices_;
+
+        //Bounds (in clip space) of the pending labels, and their union
+        std::vector<Magnum::Range2D> pending_label_bounds_;
+        std::optional<Magnum::Range2D> opt_pending_label_bounds_union_;
+
+        Magnum::GL::Buffer rectangle_vertex_buffer_;
+        Magnum::GL::Buffer glyph_vertex_buffer_;
+        Magnum::GL::Buffer index_buffer_;
+        Magnum::GL::Mesh rectangle_mesh_;
+        Magnum::GL::Mesh glyph_mesh_;
+};
+
+} //namespace
+
+#endif
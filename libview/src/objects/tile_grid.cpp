@@ -171,7 +171,8 @@ tile_grid::tile_grid
     drawables_(drawables),
     animables_(animables),
     animator_(animator),
-    next_input_(*this, drawables, animables),
+    batch_(*this, drawables),
+    next_input_(*this, drawables, batch_, animables),
     input_(*this, animables, drop_cb, layout_cb)
 {
     //board corners
@@ -218,6 +219,11 @@ bool tile_grid::is_animating() const
     return animator_.is_animating();
 }
 
+void tile_grid::set_paused(const bool value)
+{
+    batch_.set_paused(value);
+}
+
 const data_types::input_layout& tile_grid::get_input_layout() const
 {
     return input_.get_layout();
@@ -442,7 +448,7 @@ void tile_grid::merge_tiles
                                 .pobj = ptile,
                                 .finish_alpha = 0,
                                 .duration_s = track_duration_s,
-                                .interpolator = animation::get_exponential_in_float_interpolator()
+                                .easing_id = animation::easing::exponential_in
                             }
                         );
 
@@ -484,7 +490,7 @@ void tile_grid::merge_tiles
                 .pobj = pdst_tile,
                 .finish_alpha = 1,
                 .duration_s = track_duration_s,
-                .interpolator = animation::get_exponential_out_float_interpolator()
+                .easing_id = animation::easing::exponential_out
             }
         );
 
@@ -496,7 +502,7 @@ void tile_grid::merge_tiles
                 .pobj = pdst_tile,
                 .finish_scaling = {tile_scaling_factor, tile_scaling_factor},
                 .duration_s = track_duration_s,
-                .interpolator = animation::get_back_out_vector2_interpolator()
+                .easing_id = animation::easing::back_out
             }
         );
     }
@@ -656,6 +662,7 @@ void tile_grid::set_board_tiles(const data_types::board_tile_matrix& tiles)
         },
         tiles
     );
+    request_redraw();
 }
 
 void tile_grid::advance(const std::chrono::steady_clock::time_point& now, const float /*elapsed_s*/)
@@ -679,7 +686,7 @@ std::shared_ptr<object2d> tile_grid::make_tile
     const Magnum::Vector2& position
 )
 {
-    auto ptile = tile_grid_detail::make_tile_object(*this, drawables_, animables_, tile);
+    auto ptile = tile_grid_detail::make_tile_object(*this, drawables_, batch_, animables_, tile);
     ptile->setScaling({tile_scaling_factor, tile_scaling_factor});
     ptile->setTranslation(position);
     return ptile;
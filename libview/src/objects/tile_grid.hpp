@@ -22,6 +22,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "tile_grid_detail/input.hpp"
 #include "tile_grid_detail/next_input.hpp"
+#include "tile_batch.hpp"
 #include "number_tile.hpp"
 #include "sdf_image_tile.hpp"
 #include "sdf_image.hpp"
@@ -30,7 +31,6 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <libview/data_types.hpp>
 #include <libgame.hpp>
 #include <libutil/matrix.hpp>
-#include <Magnum/Animation/Player.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Shaders/VertexColor.h>
 #include <chrono>
@@ -73,6 +73,9 @@ class tile_grid: public object2d, public features::animable
 
         bool is_animating() const;
 
+        //Freeze or unfreeze the decoration animations of the tiles
+        void set_paused(bool value);
+
         const data_types::input_layout& get_input_layout() const;
 
         void clear();
@@ -132,6 +135,9 @@ class tile_grid: public object2d, public features::animable
 
         animation::animator& animator_;
 
+        //Must outlive the tiles
+        tile_batch batch_;
+
         std::vector<std::unique_ptr<sdf_image>> board_corners_;
         data_types::input_layout input_layout_;
         board_tile_matrix board_tiles_ = {};
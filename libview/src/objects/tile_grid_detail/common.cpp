@@ -23,6 +23,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include "../sdf_image_tile.hpp"
 #include "../granite_tile.hpp"
 #include <libres.hpp>
+#include <libutil/object_pool.hpp>
 #include <libutil/overload.hpp>
 
 namespace libview::objects::tile_grid_detail
@@ -32,12 +33,13 @@ std::shared_ptr<object2d> make_tile_object
 (
     object2d& parent,
     features::drawable_group& drawables,
+    tile_batch& batch,
     features::animable_group& animables,
     const data_types::tile& tile
 )
 {
     using result_t = std::shared_ptr<object2d>;
-    using path_list = std::vector<std::filesystem::path>;
+    using image_list = std::vector<libres::images::image>;
 
     return std::visit
     (
@@ -45,21 +47,21 @@ std::shared_ptr<object2d> make_tile_object
         {
             [&](const data_types::tiles::number& tile) -> result_t
             {
-                return std::make_shared<number_tile>
+                return libutil::make_pooled_shared<number_tile>
                 (
                     parent,
-                    drawables,
+                    batch,
                     animables,
                     tile.value
                 );
             },
             [&](const data_types::tiles::column_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null,
                         libres::images::special_tile_modifier_column
@@ -68,11 +70,11 @@ std::shared_ptr<object2d> make_tile_object
             },
             [&](const data_types::tiles::row_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null,
                         libres::images::special_tile_modifier_row
@@ -81,11 +83,11 @@ std::shared_ptr<object2d> make_tile_object
             },
             [&](const data_types::tiles::number_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null,
                         libres::images::special_tile_modifier_star
@@ -94,11 +96,11 @@ std::shared_ptr<object2d> make_tile_object
             },
             [&](const data_types::tiles::outer_columns_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null,
                         libres::images::special_tile_modifier_outer_columns
@@ -107,7 +109,7 @@ std::shared_ptr<object2d> make_tile_object
             },
             [&](const data_types::tiles::granite& tile) -> result_t
             {
-                return std::make_shared<granite_tile>
+                return libutil::make_pooled_shared<granite_tile>
                 (
                     parent,
                     drawables,
@@ -116,7 +118,7 @@ std::shared_ptr<object2d> make_tile_object
             },
             [&](const data_types::tiles::adder& tile) -> result_t
             {
-                return std::make_shared<adder_tile>
+                return libutil::make_pooled_shared<adder_tile>
                 (
                     parent,
                     drawables,
@@ -137,7 +139,7 @@ std::shared_ptr<object2d> make_preview_tile_object
 )
 {
     using result_t = std::shared_ptr<object2d>;
-    using path_list = std::vector<std::filesystem::path>;
+    using image_list = std::vector<libres::images::image>;
 
     return std::visit
     (
@@ -149,11 +151,11 @@ std::shared_ptr<object2d> make_preview_tile_object
             },
             [&](const data_types::tiles::column_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null
                     }
@@ -161,11 +163,11 @@ std::shared_ptr<object2d> make_preview_tile_object
             },
             [&](const data_types::tiles::row_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null
                     }
@@ -173,11 +175,11 @@ std::shared_ptr<object2d> make_preview_tile_object
             },
             [&](const data_types::tiles::number_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null
                     }
@@ -185,11 +187,11 @@ std::shared_ptr<object2d> make_preview_tile_object
             },
             [&](const data_types::tiles::outer_columns_nullifier&) -> result_t
             {
-                return std::make_shared<sdf_image_tile>
+                return libutil::make_pooled_shared<sdf_image_tile>
                 (
                     parent,
                     drawables,
-                    path_list
+                    image_list
                     {
                         libres::images::special_tile_symbol_null
                     }
@@ -201,7 +203,7 @@ std::shared_ptr<object2d> make_preview_tile_object
             },
             [&](const data_types::tiles::adder& tile) -> result_t
             {
-                return std::make_shared<adder_tile>
+                return libutil::make_pooled_shared<adder_tile>
                 (
                     parent,
                     drawables,
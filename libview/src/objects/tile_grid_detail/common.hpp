@@ -20,6 +20,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBVIEW_OBJECTS_TILE_GRID_DETAIL_COMMON_HPP
 #define LIBVIEW_OBJECTS_TILE_GRID_DETAIL_COMMON_HPP
 
+#include "../tile_batch.hpp"
 #include "../../animation.hpp"
 #include "../../common.hpp"
 #include <libview/data_types.hpp>
@@ -34,10 +35,12 @@ using input_tile_object_matrix = libutil::matrix
     libgame::constants::input_row_count
 >;
 
+//Number tiles are drawn by the given batch, other tiles by the given group
 std::shared_ptr<object2d> make_tile_object
 (
     object2d& parent,
     features::drawable_group& drawables,
+    tile_batch& batch,
     features::animable_group& animables,
     const data_types::tile& tile
 );
@@ -310,7 +310,7 @@ void input::set_tiles(const input_tile_object_matrix& tiles)
                             ptile,
                             dst_position,
                             animation_duration_s,
-                            animation::get_cubic_out_vector2_interpolator()
+                            animation::easing::cubic_out
                         }
                     );
                     anim.add
@@ -320,7 +320,7 @@ void input::set_tiles(const input_tile_object_matrix& tiles)
                             ptile,
                             {0.46f, 0.46f},
                             animation_duration_s,
-                            animation::get_cubic_out_vector2_interpolator()
+                            animation::easing::cubic_out
                         }
                     );
                     anim.add
@@ -444,6 +444,11 @@ void input::advance(const std::chrono::steady_clock::time_point& now, float elap
     update_layout();
 }
 
+bool input::is_animating() const
+{
+    return !suspended_ && (insertion_animator_.is_animating() || !settled_);
+}
+
 void input::handle_button_press(data_types::move_button button)
 {
     switch(button)
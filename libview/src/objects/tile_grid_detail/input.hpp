@@ -77,6 +77,8 @@ class input: public object2d, public features::animable
 
         void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s) override;
 
+        bool is_animating() const override;
+
     //Keyboard event handling
     public:
         void handle_button_press(data_types::move_button button);
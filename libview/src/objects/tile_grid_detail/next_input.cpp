@@ -33,11 +33,13 @@ next_input::next_input
 (
     object2d& parent,
     features::drawable_group& drawables,
+    tile_batch& batch,
     features::animable_group& animables
 ):
     object2d(&parent),
     features::animable(*this, &animables),
     drawables_(drawables),
+    batch_(batch),
     animables_(animables)
 {
 }
@@ -58,7 +60,7 @@ void next_input::create_tiles(const data_types::input_tile_matrix& tiles)
                 const auto x = (col - 0.5f) / 1.28f;
                 const auto y = (row - 0.5f) / 1.28f;
 
-                pnext_input_tile = make_tile_object(*this, drawables_, animables_, opt_tile.value());
+                pnext_input_tile = make_tile_object(*this, drawables_, batch_, animables_, opt_tile.value());
                 pnext_input_tile->set_alpha(0);
                 pnext_input_tile->setScaling({0.36f, 0.36f});
                 pnext_input_tile->setTranslation({x, y});
@@ -108,4 +110,9 @@ void next_input::advance(const std::chrono::steady_clock::time_point& now, float
     }
 }
 
+bool next_input::is_animating() const
+{
+    return !suspended_ && animator_.is_animating();
+}
+
 } //namespace
@@ -35,6 +35,7 @@ class next_input: public object2d, public features::animable
         (
             object2d& parent,
             features::drawable_group& drawables,
+            tile_batch& batch,
             features::animable_group& animables
         );
 
@@ -50,8 +51,11 @@ class next_input: public object2d, public features::animable
 
         void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s) override;
 
+        bool is_animating() const override;
+
     private:
         features::drawable_group& drawables_;
+        tile_batch& batch_;
         features::animable_group& animables_;
 
         animation::animator animator_;
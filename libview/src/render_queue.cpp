@@ -0,0 +1,145 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "render_queue.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+namespace libview
+{
+
+namespace
+{
+    std::optional<Magnum::Range2D> transform_bounds
+    (
+        const std::optional<Magnum::Range2D>& opt_bounds,
+        const Magnum::Matrix3& transformation_matrix
+    )
+    {
+        if(!opt_bounds)
+        {
+            return std::nullopt;
+        }
+
+        return transform_range(*opt_bounds, transformation_matrix);
+    }
+
+    bool overlap
+    (
+        const std::optional<Magnum::Range2D>& opt_lhs,
+        const std::optional<Magnum::Range2D>& opt_rhs
+    )
+    {
+        if(!opt_lhs || !opt_rhs)
+        {
+            return true;
+        }
+
+        const auto& lhs = *opt_lhs;
+        const auto& rhs = *opt_rhs;
+        return
+            lhs.min().x() < rhs.max().x() && rhs.min().x() < lhs.max().x() &&
+            lhs.min().y() < rhs.max().y() && rhs.min().y() < lhs.max().y()
+        ;
+    }
+
+    auto get_address(const void* ptr)
+    {
+        return reinterpret_cast<std::uintptr_t>(ptr);
+    }
+}
+
+void render_queue::draw(camera& cam, features::drawable_group& drawables)
+{
+    auto transformations = cam.drawableTransformations(drawables);
+
+    //Give a layer to each drawable
+    items_.clear();
+    for(auto i = std::size_t{0}; i < transformations.size(); ++i)
+    {
+        const auto& [drawable_ref, transformation_matrix] = transformations[i];
+
+        //All the drawables of the view are features::drawable
+        const auto& drw = static_cast<const features::drawable&>(drawable_ref.get());
+
+        auto current = item
+        {
+            .index = i,
+            .state = drw.get_state(),
+            .bounds = transform_bounds(drw.get_bounds(), transformation_matrix)
+        };
+
+        for(const auto& preceding: items_)
+        {
+            if(overlap(preceding.bounds, current.bounds))
+            {
+                const auto min_layer = preceding.state == current.state ?
+                    preceding.layer :
+                    preceding.layer + 1
+                ;
+                current.layer = std::max(current.layer, min_layer);
+            }
+        }
+
+        items_.push_back(current);
+    }
+
+    std::sort
+    (
+        items_.begin(),
+        items_.end(),
+        [](const item& lhs, const item& rhs)
+        {
+            return
+                std::tuple{lhs.layer, get_address(lhs.state.pshader), get_address(lhs.state.ptexture), lhs.index} <
+                std::tuple{rhs.layer, get_address(rhs.state.pshader), get_address(rhs.state.ptexture), rhs.index}
+            ;
+        }
+    );
+
+    //Draw, and count the switches
+    statistics_ = {};
+    sorted_transformations_.clear();
+    auto pcurrent_shader = static_cast<const void*>(nullptr);
+    auto pcurrent_texture = static_cast<const void*>(nullptr);
+    for(const auto& itm: items_)
+    {
+        sorted_transformations_.push_back(transformations[itm.index]);
+
+        ++statistics_.draw_count;
+
+        //An unknown shader is assumed to be different from any other
+        if(!itm.state.pshader || itm.state.pshader != pcurrent_shader)
+        {
+            ++statistics_.shader_switch_count;
+        }
+        pcurrent_shader = itm.state.pshader;
+
+        if(itm.state.ptexture && itm.state.ptexture != pcurrent_texture)
+        {
+            ++statistics_.texture_switch_count;
+            pcurrent_texture = itm.state.ptexture;
+        }
+    }
+
+    cam.draw(sorted_transformations_);
+}
+
+} //namespace
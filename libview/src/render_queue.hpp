@@ -0,0 +1,90 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBVIEW_RENDER_QUEUE_HPP
+#define LIBVIEW_RENDER_QUEUE_HPP
+
+#include "common.hpp"
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Range.h>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace libview
+{
+
+/*
+Draws the drawables of a group in an order that minimizes the shader and
+texture switches.
+
+Everything is alpha-blended, so two drawables that overlap and that don't use
+the same state must be drawn in their original order (the order in which they
+have been added to the group). To ensure this, each drawable is given a layer
+greater than the layer of every preceding drawable it overlaps with a
+different state.
+Drawables are then drawn by layer, shader, texture and original order.
+*/
+class render_queue
+{
+    public:
+        //Counts of the last call to draw()
+        struct statistics
+        {
+            int draw_count = 0;
+            int shader_switch_count = 0;
+            int texture_switch_count = 0;
+        };
+
+    public:
+        void draw(camera& cam, features::drawable_group& drawables);
+
+        const statistics& get_statistics() const
+        {
+            return statistics_;
+        }
+
+    private:
+        using drawable_transformation = std::pair
+        <
+            std::reference_wrapper<Magnum::SceneGraph::Drawable2D>,
+            Magnum::Matrix3
+        >;
+
+        struct item
+        {
+            std::size_t index = 0;
+            int layer = 0;
+            features::drawable::state state;
+            std::optional<Magnum::Range2D> bounds; //in camera space
+        };
+
+    private:
+        //Kept from one frame to the next to avoid reallocations
+        std::vector<item> items_;
+        std::vector<drawable_transformation> sorted_transformations_;
+
+        statistics statistics_;
+};
+
+} //namespace
+
+#endif
@@ -46,8 +46,8 @@ namespace
         const data_types::stage stage
     )
     {
-        const auto opt_background_image_path = data_types::get_image(stage);
-        if(!opt_background_image_path)
+        const auto opt_background_image = data_types::get_image(stage);
+        if(!opt_background_image)
         {
             return nullptr;
         }
@@ -56,7 +56,7 @@ namespace
         (
             parent,
             feature_groups.drawables,
-            *opt_background_image_path,
+            *opt_background_image,
             objects::sdf_image::style
             {
                 .color = colors::white
@@ -296,6 +296,11 @@ void game::advance(const std::chrono::steady_clock::time_point& now, const float
     pimpl_->pause_animator.advance(now);
 }
 
+bool game::is_animating() const
+{
+    return pimpl_->animator.is_animating() || pimpl_->pause_animator.is_animating();
+}
+
 void game::handle_key_press(key_event& event)
 {
     switch(event.key())
@@ -71,7 +71,7 @@ class showing_game_over_overlay
                     .pobj = pgame_over_overlay_,
                     .finish_position = {0.0f, 4.5f},
                     .duration_s = 0.5f,
-                    .interpolator = animation::get_cubic_out_vector2_interpolator()
+                    .easing_id = animation::easing::cubic_out
                 }
             );
             anim.add
@@ -96,7 +96,7 @@ class showing_game_over_overlay
                     .pobj = pgame_over_overlay_,
                     .finish_position = {0.0f, 5.5f},
                     .duration_s = 0.5f,
-                    .interpolator = animation::get_cubic_out_vector2_interpolator()
+                    .easing_id = animation::easing::cubic_out
                 }
             );
             anim.add
@@ -49,6 +49,7 @@ void showing_menu_overlay::on_entry()
     );
 
     ctx_.animator.pause();
+    ctx_.tile_grid.set_paused(true);
 
     pmenu_overlay_->setTranslation({0.0f, 3.5f});
     pmenu_overlay_->set_alpha(0);
@@ -64,7 +65,7 @@ void showing_menu_overlay::on_entry()
             .pobj = pmenu_overlay_,
             .finish_position = {0.0f, 3.0f},
             .duration_s = 0.3f,
-            .interpolator = animation::get_cubic_out_vector2_interpolator()
+            .easing_id = animation::easing::cubic_out
         }
     );
     anim.add
@@ -107,7 +108,7 @@ void showing_menu_overlay::on_exit()
             .pobj = pmenu_overlay_,
             .finish_position = {0.0f, 3.5f},
             .duration_s = 0.3f,
-            .interpolator = animation::get_cubic_out_vector2_interpolator()
+            .easing_id = animation::easing::cubic_out
         }
     );
     anim.add
@@ -122,6 +123,7 @@ void showing_menu_overlay::on_exit()
     ctx_.pause_animator.push(std::move(anim));
 
     ctx_.animator.resume();
+    ctx_.tile_grid.set_paused(false);
 
     pmenu_overlay_.reset();
 }
@@ -61,8 +61,8 @@ namespace
                 const data_types::stage stage
             )
             {
-                const auto opt_path = data_types::get_image(stage);
-                if(!opt_path)
+                const auto opt_image = data_types::get_image(stage);
+                if(!opt_image)
                 {
                     return nullptr;
                 }
@@ -71,7 +71,7 @@ namespace
                 (
                     parent,
                     feature_groups.drawables,
-                    *opt_path,
+                    *opt_image,
                     objects::sdf_image::style
                     {
                         .color = colors::black
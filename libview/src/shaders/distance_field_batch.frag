@@ -0,0 +1,60 @@
+R"^(/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform lowp sampler2D u_texture;
+
+varying mediump vec2 v_texture_coordinates;
+varying lowp vec4 v_color;
+varying lowp vec4 v_outline_color;
+varying mediump vec3 v_shape; //outline range start, outline range end, smoothness
+
+//Same computation as Magnum::Shaders::DistanceFieldVector
+void main()
+{
+    vec2 outline_range = v_shape.xy;
+    float smoothness = v_shape.z;
+
+    float intensity = texture2D(u_texture, v_texture_coordinates).r;
+
+    //Fill
+    gl_FragColor = smoothstep
+    (
+        outline_range.x - smoothness,
+        outline_range.x + smoothness,
+        intensity
+    ) * v_color;
+
+    //Outline
+    if(outline_range.x > outline_range.y)
+    {
+        float mid = (outline_range.x + outline_range.y) / 2.0;
+        float half_range = (outline_range.x - outline_range.y) / 2.0;
+        gl_FragColor += smoothstep
+        (
+            half_range + smoothness,
+            half_range - smoothness,
+            distance(mid, intensity)
+        ) * v_outline_color;
+    }
+}
+)^"
@@ -0,0 +1,67 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBVIEW_SHADERS_DISTANCE_FIELD_BATCH_HPP
+#define LIBVIEW_SHADERS_DISTANCE_FIELD_BATCH_HPP
+
+#include "Magnum/GL/AbstractShaderProgram.h"
+#include "Magnum/GL/Texture.h"
+#include "Magnum/Math/Color.h"
+#include "Magnum/Math/Vector3.h"
+
+namespace libview::shaders
+{
+
+/*
+Same as Magnum::Shaders::DistanceFieldVector2D, but with the parameters given
+per vertex.
+Vertex positions are expected to be already transformed into clip space.
+*/
+class distance_field_batch: public Magnum::GL::AbstractShaderProgram
+{
+    public:
+        typedef Magnum::GL::Attribute<0, Magnum::Vector2> Position;
+        typedef Magnum::GL::Attribute<1, Magnum::Vector2> TextureCoordinates;
+        typedef Magnum::GL::Attribute<2, Magnum::Vector4> Color;
+        typedef Magnum::GL::Attribute<3, Magnum::Vector4> OutlineColor;
+        typedef Magnum::GL::Attribute<4, Magnum::Vector3> Shape; //outline range start, outline range end, smoothness
+
+        explicit distance_field_batch();
+
+        distance_field_batch(const distance_field_batch&) = delete;
+
+        distance_field_batch(distance_field_batch&&) noexcept = default;
+
+        distance_field_batch& operator=(const distance_field_batch&) = delete;
+
+        distance_field_batch& operator=(distance_field_batch&&) noexcept = default;
+
+        distance_field_batch& bind_texture(Magnum::GL::Texture2D& texture)
+        {
+            texture.bind(texture_unit);
+            return *this;
+        }
+
+    private:
+        static constexpr Magnum::Int texture_unit = 0;
+};
+
+} //namespace
+
+#endif
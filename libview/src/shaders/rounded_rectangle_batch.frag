@@ -0,0 +1,71 @@
+R"^(/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+varying highp vec2 v_position;
+varying lowp vec4 v_color;
+varying lowp vec4 v_outline_color;
+varying mediump vec2 v_dimension; //normalized dimension of rectangle
+varying mediump vec3 v_shape; //radius, smoothness, outline thickness
+
+void main()
+{
+    float radius = v_shape.x;
+    float smoothness = v_shape.y;
+    float outline_thickness = v_shape.z;
+
+    vec2 abs_pos = abs(v_position);
+
+    //Are we inside the rectangle?
+    if(abs_pos.x > v_dimension.x || abs_pos.y > v_dimension.y)
+    {
+        discard;
+    }
+
+    //Compute the distance to the inner rectangle whose vertices are the centers
+    //of the circles that make the corners.
+    //Same result as the branches of rounded_rectangle.frag.
+    float dist = length(max(abs_pos - (v_dimension - vec2(radius)), 0.0));
+
+    //Fill
+    float fill_alpha = 1.0 - smoothstep
+    (
+        radius - outline_thickness - smoothness,
+        radius - outline_thickness,
+        dist
+    );
+    gl_FragColor = v_color * fill_alpha;
+
+    //Outline
+    if(outline_thickness > 0.0)
+    {
+        float outline_alpha_0 = 1.0 - fill_alpha;
+        float outline_alpha_1 = 1.0 - smoothstep
+        (
+            radius - smoothness,
+            radius,
+            dist
+        );
+        gl_FragColor += v_outline_color * outline_alpha_0 * outline_alpha_1;
+    }
+}
+)^"
@@ -0,0 +1,57 @@
+/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBVIEW_SHADERS_ROUNDED_RECTANGLE_BATCH_HPP
+#define LIBVIEW_SHADERS_ROUNDED_RECTANGLE_BATCH_HPP
+
+#include "Magnum/GL/AbstractShaderProgram.h"
+#include "Magnum/Math/Color.h"
+#include "Magnum/Math/Vector3.h"
+
+namespace libview::shaders
+{
+
+/*
+Same as rounded_rectangle, but with the parameters given per vertex.
+Vertex positions are expected to be already transformed into clip space.
+*/
+class rounded_rectangle_batch: public Magnum::GL::AbstractShaderProgram
+{
+    public:
+        typedef Magnum::GL::Attribute<0, Magnum::Vector2> Position;
+        typedef Magnum::GL::Attribute<1, Magnum::Vector2> LocalPosition;
+        typedef Magnum::GL::Attribute<2, Magnum::Vector4> Color;
+        typedef Magnum::GL::Attribute<3, Magnum::Vector4> OutlineColor;
+        typedef Magnum::GL::Attribute<4, Magnum::Vector2> Dimension;
+        typedef Magnum::GL::Attribute<5, Magnum::Vector3> Shape; //radius, smoothness, outline thickness
+
+        explicit rounded_rectangle_batch();
+
+        rounded_rectangle_batch(const rounded_rectangle_batch&) = delete;
+
+        rounded_rectangle_batch(rounded_rectangle_batch&&) noexcept = default;
+
+        rounded_rectangle_batch& operator=(const rounded_rectangle_batch&) = delete;
+
+        rounded_rectangle_batch& operator=(rounded_rectangle_batch&&) noexcept = default;
+};
+
+} //namespace
+
+#endif
@@ -0,0 +1,47 @@
+R"^(/*
+Copyright 2018 - 2022 Florian Goujeon
+
+This file is part of Ternarii.
+
+Ternarii is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Ternarii is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+Rounded rectangle whose parameters are given per vertex, so that many
+rectangles can be drawn with a single draw call.
+*/
+
+attribute highp vec2 position; //already in clip space
+attribute highp vec2 local_position; //in the unit square
+attribute lowp vec4 color;
+attribute lowp vec4 outline_color;
+attribute mediump vec2 dimension;
+attribute mediump vec3 shape; //radius, smoothness, outline thickness
+
+varying highp vec2 v_position;
+varying lowp vec4 v_color;
+varying lowp vec4 v_outline_color;
+varying mediump vec2 v_dimension;
+varying mediump vec3 v_shape;
+
+void main()
+{
+    v_position = local_position;
+    v_color = color;
+    v_outline_color = outline_color;
+    v_dimension = dimension;
+    v_shape = shape;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)^"
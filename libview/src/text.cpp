@@ -18,6 +18,14 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "text.hpp"
+#include <Magnum/Text/Renderer.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <string>
+#include <tuple>
 
 namespace libview::text
 {
@@ -60,4 +68,145 @@ Magnum::Shaders::DistanceFieldVector2D& get_shader()
     return shader;
 }
 
+const layout& get_layout
+(
+    const std::string_view& value,
+    const float font_size,
+    const Magnum::Text::Alignment alignment
+)
+{
+    //Nodes of std::map are stable, so references to layouts stay valid
+    using key = std::tuple<std::string, float, Magnum::Text::Alignment>;
+    static auto layouts = std::map<key, layout>{};
+
+    auto k = key{value, font_size, alignment};
+    if(const auto it = layouts.find(k); it != layouts.end())
+    {
+        return it->second;
+    }
+
+    auto [positions, texture_coordinates, indices, bounds] = Magnum::Text::Renderer2D::render
+    (
+        get_font(),
+        get_glyph_cache(),
+        font_size,
+        std::get<0>(k),
+        alignment
+    );
+
+    return layouts.emplace
+    (
+        std::move(k),
+        layout
+        {
+            .positions = std::move(positions),
+            .texture_coordinates = std::move(texture_coordinates),
+            .indices = std::move(indices)
+        }
+    ).first->second;
+}
+
+dynamic_text::dynamic_text
+(
+    const float font_size,
+    const Magnum::Text::Alignment alignment,
+    const std::size_t capacity
+):
+    font_size_(font_size),
+    alignment_(alignment),
+    vertex_buffer_{Magnum::GL::Buffer::TargetHint::Array},
+    index_buffer_{Magnum::GL::Buffer::TargetHint::ElementArray}
+{
+    mesh_
+        .setPrimitive(Magnum::GL::MeshPrimitive::Triangles)
+        .addVertexBuffer
+        (
+            vertex_buffer_,
+            0,
+            Magnum::Shaders::DistanceFieldVector2D::Position{},
+            Magnum::Shaders::DistanceFieldVector2D::TextureCoordinates{}
+        )
+        .setIndexBuffer(index_buffer_, 0, Magnum::GL::MeshIndexType::UnsignedShort)
+        .setCount(0)
+    ;
+
+    reserve(capacity);
+}
+
+void dynamic_text::set_text(const std::string_view& value)
+{
+    auto [positions, texture_coordinates, indices, bounds] = Magnum::Text::Renderer2D::render
+    (
+        get_font(),
+        get_glyph_cache(),
+        font_size_,
+        std::string{value},
+        alignment_
+    );
+
+    const auto glyph_count = positions.size() / 4;
+    if(glyph_count > capacity_)
+    {
+        reserve(std::max(glyph_count, capacity_ * 2));
+    }
+
+    //Update our copy of the vertex buffer, and find the range of vertices
+    //that changed
+    auto first_changed_vertex_index = std::size_t{0};
+    auto changed_vertex_count = std::size_t{0};
+    for(auto i = std::size_t{0}; i < positions.size(); ++i)
+    {
+        auto& v = vertices_[i];
+        if(v.position != positions[i] || v.texture_coordinates != texture_coordinates[i])
+        {
+            if(changed_vertex_count == 0)
+            {
+                first_changed_vertex_index = i;
+            }
+            changed_vertex_count = i + 1 - first_changed_vertex_index;
+
+            v.position = positions[i];
+            v.texture_coordinates = texture_coordinates[i];
+        }
+    }
+
+    if(changed_vertex_count != 0)
+    {
+        vertex_buffer_.setSubData
+        (
+            static_cast<GLintptr>(first_changed_vertex_index * sizeof(vertex)),
+            Corrade::Containers::arrayView(vertices_.data() + first_changed_vertex_index, changed_vertex_count)
+        );
+    }
+
+    glyph_count_ = glyph_count;
+    bounds_ = bounds;
+    mesh_.setCount(static_cast<Magnum::Int>(glyph_count * 6));
+}
+
+void dynamic_text::reserve(const std::size_t capacity)
+{
+    //Indices are 16-bit
+    assert(capacity * 4 <= std::size_t{std::numeric_limits<Magnum::UnsignedShort>::max()} + 1);
+
+    capacity_ = capacity;
+
+    vertices_.assign(capacity * 4, vertex{});
+    vertex_buffer_.setData(Corrade::Containers::arrayView(vertices_), Magnum::GL::BufferUsage::DynamicDraw);
+
+    //Same index layout as Magnum::Text::Renderer
+    auto indices = std::vector<Magnum::UnsignedShort>(capacity * 6);
+    for(auto i = std::size_t{0}; i < capacity; ++i)
+    {
+        const auto first_vertex_index = static_cast<Magnum::UnsignedShort>(i * 4);
+        indices[i * 6 + 0] = first_vertex_index;
+        indices[i * 6 + 1] = first_vertex_index + 1;
+        indices[i * 6 + 2] = first_vertex_index + 2;
+        indices[i * 6 + 3] = first_vertex_index + 1;
+        indices[i * 6 + 4] = first_vertex_index + 3;
+        indices[i * 6 + 5] = first_vertex_index + 2;
+    }
+    index_buffer_.setData(Corrade::Containers::arrayView(indices), Magnum::GL::BufferUsage::StaticDraw);
+}
+
 } //namespace
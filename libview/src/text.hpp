@@ -24,6 +24,14 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <MagnumPlugins/MagnumFont/MagnumFont.h>
 #include <Magnum/Shaders/DistanceFieldVector.h>
 #include <Magnum/Text/GlyphCache.h>
+#include <Magnum/Text/Alignment.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Magnum.h>
+#include <cstddef>
+#include <string_view>
+#include <vector>
 
 namespace libview::text
 {
@@ -34,6 +42,92 @@ Magnum::Text::GlyphCache& get_glyph_cache();
 
 Magnum::Shaders::DistanceFieldVector2D& get_shader();
 
+//Glyph quads of a text, in the coordinate system of the text
+struct layout
+{
+    std::vector<Magnum::Vector2> positions;
+    std::vector<Magnum::Vector2> texture_coordinates;
+    std::vector<Magnum::UnsignedInt> indices;
+};
+
+/*
+Return the layout of the given text.
+Layouts are computed on first use and shared by all the callers. The returned
+reference is valid until the end of the program.
+*/
+const layout& get_layout
+(
+    const std::string_view& value,
+    float font_size,
+    Magnum::Text::Alignment alignment
+);
+
+/*
+Mesh of a text whose value changes often (e.g. a score or a time), to be
+drawn with get_shader().
+
+The GPU buffers are allocated once, for the given maximum number of glyphs,
+and are only reallocated if a longer text is set.
+Setting a new value only uploads the range of glyphs that differ from the
+previous value, and nothing at all if no glyph differs.
+*/
+class dynamic_text
+{
+    public:
+        dynamic_text
+        (
+            float font_size,
+            Magnum::Text::Alignment alignment,
+            std::size_t capacity
+        );
+
+        dynamic_text(const dynamic_text&) = delete;
+
+        dynamic_text& operator=(const dynamic_text&) = delete;
+
+        void set_text(const std::string_view& value);
+
+        std::size_t get_glyph_count() const
+        {
+            return glyph_count_;
+        }
+
+        //Bounds of the glyphs of the current text
+        const Magnum::Range2D& get_bounds() const
+        {
+            return bounds_;
+        }
+
+        Magnum::GL::Mesh& get_mesh()
+        {
+            return mesh_;
+        }
+
+    private:
+        struct vertex
+        {
+            Magnum::Vector2 position;
+            Magnum::Vector2 texture_coordinates;
+        };
+
+    private:
+        void reserve(std::size_t capacity);
+
+    private:
+        float font_size_;
+        Magnum::Text::Alignment alignment_;
+        std::size_t capacity_ = 0;
+        std::size_t glyph_count_ = 0;
+        Magnum::Range2D bounds_;
+
+        //Copy of the content of vertex_buffer_
+        std::vector<vertex> vertices_;
+
+        Magnum::GL::Buffer vertex_buffer_;
+        Magnum::GL::Buffer index_buffer_;
+        Magnum::GL::Mesh mesh_;
+};
+
 } //namespace
 
 #endif
@@ -20,9 +20,12 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <libview/view.hpp>
 #include "objects/label.hpp"
 #include "objects/debug_grid.hpp"
+#include "render_queue.hpp"
+#include "hit_test_grid.hpp"
 #include "colors.hpp"
 #include "animation.hpp"
 #include "common.hpp"
+#include <libutil/format.hpp>
 #include <libutil/overload.hpp>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
@@ -30,6 +33,7 @@ along with Ternarii.  If not, see <https://www.gnu.org/licenses/>.
 #include <Magnum/GL/Version.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Platform/Sdl2Application.h>
+#include <array>
 #include <chrono>
 #include <map>
 
@@ -45,6 +49,14 @@ namespace
     };
 
     using keyboard_state = std::map<view::key, key_state>;
+
+    //See request_redraw()
+    bool redraw_requested = true;
+}
+
+void request_redraw()
+{
+    redraw_requested = true;
 }
 
 struct view::impl final
@@ -74,7 +86,8 @@ struct view::impl final
                 {
                     .alignment = Magnum::Text::Alignment::MiddleLeft,
                     .color = colors::white,
-                    .font_size = 0.3f
+                    .font_size = 0.3f,
+                    .capacity = 64
                 }
             );
             pfps_counter->translate({-4.0f, -7.0f});
@@ -88,6 +101,14 @@ struct view::impl final
 
     void advance(const std::chrono::steady_clock::time_point& now, float elapsed_s)
     {
+        //The last frame of an animation that ends now must be drawn
+        //(animables may depend on absolute alphas, which must be up to date)
+        scene.update_absolute_alphas();
+        if(is_animating())
+        {
+            request_redraw();
+        }
+
         //Advance animations
         screen_transition_animator.advance(now);
         for(std::size_t i = 0; i < feature_groups.animables.size(); ++i)
@@ -102,27 +123,64 @@ struct view::impl final
             if(measure_duration_s > 0.5)
             {
                 const auto fps = static_cast<int>(std::round(fps_measure_count / measure_duration_s));
-                pfps_counter->set_text(std::to_string(fps).c_str());
+                const auto& stats = render_queue.get_statistics();
+                auto buffer = std::array<char, 64>{};
+                pfps_counter->set_text
+                (
+                    libutil::format_to
+                    (
+                        buffer,
+                        "{} FPS, {} draws, {} shader/{} texture switches",
+                        fps,
+                        stats.draw_count,
+                        stats.shader_switch_count,
+                        stats.texture_switch_count
+                    )
+                );
 
                 //reset
                 fps_measure_start_time = now;
                 fps_measure_count = 0;
             }
-            else
+        }
+
+        scene.update_absolute_alphas();
+        if(is_animating())
+        {
+            request_redraw();
+        }
+    }
+
+    bool is_animating() const
+    {
+        if(screen_transition_animator.is_animating())
+        {
+            return true;
+        }
+
+        for(std::size_t i = 0; i < feature_groups.animables.size(); ++i)
+        {
+            if(feature_groups.animables[i].is_animating())
             {
-                ++fps_measure_count;
+                return true;
             }
         }
+
+        return false;
     }
 
     void draw()
     {
-        camera.draw(feature_groups.drawables);
+        scene.update_absolute_alphas();
+        render_queue.draw(camera, feature_groups.drawables);
+        redraw_requested = false;
+        ++fps_measure_count;
     }
 
     void set_viewport(const Magnum::Vector2i& size)
     {
         camera.setViewport(size);
+        request_redraw();
     }
 
     void handle_key_press(key_event& event)
@@ -237,17 +295,38 @@ struct view::impl final
             * camera.projectionSize()
         ;
 
-        for(std::size_t i = 0; i < feature_groups.clickables.size(); ++i)
+        const auto revision = features::clickable::get_revision();
+        const auto& pcandidates = hit_test_grid.get_candidates(feature_groups.clickables, world_space_position);
+
+        for(const auto pclickable: pcandidates)
         {
-            auto& clickable = feature_groups.clickables[i];
+            //Skip the clickables that have been destroyed by the callback of a
+            //previous clickable
+            if(features::clickable::get_revision() != revision && !is_in_group(pclickable))
+            {
+                continue;
+            }
 
             //Convert to model-space coordinates of clickable
-            const auto clickable_space_position = clickable.object().absoluteTransformationMatrix().inverted().transformPoint(world_space_position);
+            pclickable->object().setClean();
+            const auto clickable_space_position = pclickable->get_inverted_absolute_transformation_matrix().transformPoint(world_space_position);
 
-            f(clickable, clickable_space_position);
+            f(*pclickable, clickable_space_position);
         }
     }
 
+    bool is_in_group(const features::clickable* pclickable) const
+    {
+        for(std::size_t i = 0; i < feature_groups.clickables.size(); ++i)
+        {
+            if(&feature_groups.clickables[i] == pclickable)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     configuration conf_;
 
     scene scene;
@@ -255,6 +334,8 @@ struct view::impl final
     camera camera;
 
     feature_group_set feature_groups;
+    render_queue render_queue;
+    hit_test_grid hit_test_grid;
 
     animation::animator screen_transition_animator;
 
@@ -281,19 +362,7 @@ void view::show_screen
     const screen_transition& trans
 )
 {
-    const auto vector_interpolator = Magnum::Animation::ease
-    <
-        Magnum::Vector2,
-        Magnum::Math::lerp,
-        Magnum::Animation::Easing::exponentialOut
-    >();
-
-    const auto float_interpolator = Magnum::Animation::ease
-    <
-        Magnum::Float,
-        Magnum::Math::lerp,
-        Magnum::Animation::Easing::exponentialOut
-    >();
+    request_redraw();
 
     const auto do_translation_transition = [&]
     (
@@ -329,7 +398,7 @@ void view::show_screen
                     .pobj = pimpl_->pscreen,
                     .finish_position = old_screen_finish_position,
                     .duration_s = duration_s,
-                    .interpolator = vector_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
 
@@ -340,7 +409,7 @@ void view::show_screen
                     .pobj = pimpl_->pscreen,
                     .finish_alpha = 0.0f,
                     .duration_s = duration_s,
-                    .interpolator = float_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
         }
@@ -354,7 +423,7 @@ void view::show_screen
                     .pobj = pscreen,
                     .finish_position = {0.0f, 0.0f},
                     .duration_s = duration_s,
-                    .interpolator = vector_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
 
@@ -365,7 +434,7 @@ void view::show_screen
                     .pobj = pscreen,
                     .finish_alpha = 1.0f,
                     .duration_s = duration_s,
-                    .interpolator = float_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
         }
@@ -428,7 +497,7 @@ void view::show_screen
                     .pobj = pimpl_->pscreen,
                     .finish_position = old_screen_finish_position,
                     .duration_s = duration_s,
-                    .interpolator = vector_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
 
@@ -439,7 +508,7 @@ void view::show_screen
                     .pobj = pimpl_->pscreen,
                     .finish_scaling = old_screen_finish_scaling,
                     .duration_s = duration_s,
-                    .interpolator = vector_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
 
@@ -450,7 +519,7 @@ void view::show_screen
                     .pobj = pimpl_->pscreen,
                     .finish_alpha = 0.0f,
                     .duration_s = duration_s,
-                    .interpolator = float_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
         }
@@ -464,7 +533,7 @@ void view::show_screen
                     .pobj = pscreen,
                     .finish_position = {0.0f, 0.0f},
                     .duration_s = duration_s,
-                    .interpolator = vector_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
 
@@ -475,7 +544,7 @@ void view::show_screen
                     .pobj = pscreen,
                     .finish_scaling = Magnum::Vector2{1.0f, 1.0f},
                     .duration_s = duration_s,
-                    .interpolator = vector_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
 
@@ -486,7 +555,7 @@ void view::show_screen
                     .pobj = pscreen,
                     .finish_alpha = 1.0f,
                     .duration_s = duration_s,
-                    .interpolator = float_interpolator
+                    .easing_id = animation::easing::exponential_out
                 }
             );
         }
@@ -545,6 +614,11 @@ void view::advance
     pimpl_->advance(now, elapsed_s);
 }
 
+bool view::needs_redraw() const
+{
+    return redraw_requested;
+}
+
 void view::draw()
 {
     pimpl_->draw();
@@ -557,26 +631,31 @@ void view::set_viewport(const Magnum::Vector2i& size)
 
 void view::handle_key_press(key_event& event)
 {
+    request_redraw();
     pimpl_->handle_key_press(event);
 }
 
 void view::handle_key_release(key_event& event)
 {
+    request_redraw();
     pimpl_->handle_key_release(event);
 }
 
 void view::handle_mouse_press(mouse_event& event)
 {
+    request_redraw();
     pimpl_->handle_mouse_press(event);
 }
 
 void view::handle_mouse_release(mouse_event& event)
 {
+    request_redraw();
     pimpl_->handle_mouse_release(event);
 }
 
 void view::handle_mouse_move(mouse_move_event& event)
 {
+    request_redraw();
     pimpl_->handle_mouse_move(event);
 }
 